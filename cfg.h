@@ -6,20 +6,37 @@
 #include <string.h>
 #include <stdarg.h>
 
-typedef enum cfg_type cfg_type_t;
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef struct cfg_value cfg_value_t;
 typedef struct cfg_list cfg_list_t;
 typedef struct cfg_variable cfg_variable_t;
 typedef struct cfg_section cfg_section_t;
 typedef struct cfg_data cfg_data_t;
-
-enum cfg_type {
+typedef struct cfg_file_result cfg_file_result_t;
+typedef struct cfg_field cfg_field_t;
+typedef struct cfg_schema cfg_schema_t;
+typedef struct cfg_patch_entry cfg_patch_entry_t;
+typedef struct cfg_patch cfg_patch_t;
+typedef struct cfg_layer cfg_layer_t;
+typedef struct cfg_overlay_entry cfg_overlay_entry_t;
+typedef struct cfg_overlay cfg_overlay_t;
+typedef struct cfg_frozen_value cfg_frozen_value_t;
+typedef struct cfg_frozen_list cfg_frozen_list_t;
+typedef struct cfg_frozen_variable cfg_frozen_variable_t;
+typedef struct cfg_frozen_section cfg_frozen_section_t;
+typedef struct cfg_frozen cfg_frozen_t;
+typedef struct cfg_memory_usage cfg_memory_usage_t;
+
+typedef enum cfg_type {
 	CFG_INT,
 	CFG_FLOAT,
 	CFG_STRING,
 	CFG_BOOL,
 	CFG_LIST
-};
+} cfg_type_t;
 
 struct cfg_value {
 	cfg_type_t type;
@@ -40,19 +57,147 @@ struct cfg_list {
 
 struct cfg_variable {
 	char *name;
+	uint64_t hash; // cfg_hash of name
 	cfg_value_t value;
 };
 
 struct cfg_section {
 	char *name;
+	uint64_t hash; // cfg_hash of name
 	uint32_t count, tag_count;
 	cfg_variable_t *variables;
 	char **tags;
 };
 
 struct cfg_data {
-	uint32_t count;
+	uint32_t count, include_count;
 	cfg_section_t *sections;
+	char **includes; // Paths named by @include "path", resolved by the overlay functions
+};
+
+struct cfg_file_result {
+	cfg_data_t data;
+	int32_t error; // 0 if the file was read, otherwise the errno of the failed read
+};
+
+typedef enum cfg_patch_op {
+	CFG_PATCH_SECTION_ADD,
+	CFG_PATCH_SECTION_REMOVE,
+	CFG_PATCH_SECTION_TAGS,
+	CFG_PATCH_VARIABLE_ADD,
+	CFG_PATCH_VARIABLE_REMOVE,
+	CFG_PATCH_VARIABLE_CHANGE,
+	CFG_PATCH_LIST_ADD,
+	CFG_PATCH_LIST_REMOVE,
+	CFG_PATCH_LIST_CHANGE
+} cfg_patch_op_t;
+
+struct cfg_patch_entry {
+	cfg_patch_op_t op;
+	char *section;
+	char *variable;    // NULL for section operations
+	uint32_t section_occurrence, variable_occurrence; // Number of earlier sections or variables with the same name
+	uint32_t index;    // Insertion index of added sections and variables
+	uint32_t depth;    // Number of list indices in path, list operations only
+	uint32_t *path;    // List indices from the variable value down to the element
+	cfg_value_t value; // New value, or a list of tag strings for section operations
+};
+
+struct cfg_patch {
+	uint32_t count;
+	cfg_patch_entry_t *entries;
+};
+
+struct cfg_field {
+	char *name;
+	cfg_type_t type;   // CFG_INT binds an int32_t, CFG_FLOAT a double, CFG_STRING a char *, CFG_BOOL a uint8_t and CFG_LIST a cfg_list_t *
+	uint32_t offset;   // offsetof the member
+	cfg_value_t value; // Default, used when the section does not set the field
+};
+
+struct cfg_schema {
+	uint32_t size; // sizeof the struct
+	uint32_t count;
+	cfg_field_t *fields;
+};
+
+struct cfg_layer {
+	char *path;    // NULL for layers that were not read from a file
+	uint64_t hash; // cfg_hash of path
+	cfg_data_t data;
+};
+
+struct cfg_overlay_entry {
+	uint64_t section, variable; // Name hashes
+	uint32_t generation;
+	cfg_variable_t *value;      // NULL if no layer defines the variable
+};
+
+struct cfg_overlay {
+	uint32_t count;
+	cfg_layer_t *layers; // Lowest priority first
+	uint32_t generation; // Changes whenever a layer changes, which invalidates the cache
+	uint32_t cache_count, cache_capacity;
+	cfg_overlay_entry_t *cache;
+};
+
+// Frozen documents are read-only and live in a single allocation. Strings are referred to by their offset in
+// the string pool, every other record by its index in the array of its kind
+struct cfg_frozen_value {
+	cfg_type_t type;
+	union {
+		int32_t value_int;
+		uint32_t value_float;  // Index in floats
+		uint32_t value_string; // Offset in strings
+		uint8_t value_bool;
+		uint32_t value_list;   // Index in lists
+	};
+};
+
+struct cfg_frozen_list {
+	uint32_t first; // Index of the first element in values
+	uint32_t count;
+};
+
+struct cfg_frozen_variable {
+	uint64_t hash;  // cfg_hash of name
+	uint32_t name;  // Offset in strings
+	cfg_frozen_value_t value;
+};
+
+struct cfg_frozen_section {
+	uint64_t hash;      // cfg_hash of name
+	uint32_t name;      // Offset in strings
+	uint32_t variables; // Index of the first variable
+	uint32_t count;
+	uint32_t tags;      // Index of the first tag
+	uint32_t tag_count;
+};
+
+struct cfg_frozen {
+	uint32_t count, include_count;
+	uint32_t variable_count, float_count, value_count, list_count, tag_count;
+	uint32_t string_size;
+	cfg_frozen_section_t *sections; // Start of the allocation, the other arrays follow it
+	cfg_frozen_variable_t *variables;
+	double *floats;
+	cfg_frozen_value_t *values;     // Elements of all lists
+	cfg_frozen_list_t *lists;
+	uint32_t *tags;                 // Offsets in strings
+	uint32_t *includes;             // Offsets in strings
+	char *strings;                  // Every distinct name, string, tag and path, stored once
+};
+
+// Bytes of the records of a document, by category. Allocator overhead is not included, but comes with every allocation
+struct cfg_memory_usage {
+	uint64_t sections;    // Section records
+	uint64_t variables;   // Variable records, including their values
+	uint64_t values;      // Lists and their elements, and the doubles of frozen documents
+	uint64_t tags;        // Tag arrays
+	uint64_t includes;    // Include arrays
+	uint64_t strings;     // Names, strings, tags and include paths
+	uint64_t allocations;
+	uint64_t total;
 };
 
 // FNV hash
@@ -61,6 +206,7 @@ uint64_t cfg_hash(char *string);
 // Sections
 cfg_section_t *cfg_section_add(cfg_data_t *data, char *name, uint32_t index, uint32_t tag_count, char **tags);
 cfg_section_t *cfg_section_get(cfg_data_t *data, char *name);
+cfg_section_t *cfg_section_get_hash(cfg_data_t *data, uint64_t hash);
 int64_t cfg_section_index(cfg_data_t *data, char *name);
 uint32_t cfg_section_pointer_index(cfg_data_t *data, cfg_section_t *section);
 void cfg_section_remove(cfg_data_t *data, uint32_t index);
@@ -74,6 +220,7 @@ void cfg_list_remove(cfg_list_t *list, uint32_t index);
 // Variables
 cfg_variable_t *cfg_variable_add(cfg_section_t *section, char *name, cfg_value_t value, uint32_t index);
 cfg_variable_t *cfg_variable_get(cfg_section_t *section, char *name);
+cfg_variable_t *cfg_variable_get_hash(cfg_section_t *section, uint64_t hash);
 int64_t cfg_variable_index(cfg_section_t *section, char *name);
 uint32_t cfg_variable_pointer_index(cfg_section_t *section, cfg_variable_t *variable);
 void cfg_variable_remove(cfg_section_t *section, uint32_t index);
@@ -83,10 +230,67 @@ char *cfg_data_write(cfg_data_t data);
 cfg_data_t cfg_data_read(char *source);
 uint8_t cfg_data_write_file(char *path, cfg_data_t data);
 cfg_data_t cfg_data_read_file(char *path);
+uint32_t cfg_data_read_files(char **paths, uint32_t count, cfg_file_result_t *out);
 void cfg_data_free(cfg_data_t *data);
 
+// Patches
+cfg_patch_t cfg_data_diff(cfg_data_t *from, cfg_data_t *to);
+uint8_t cfg_data_patch(cfg_data_t *data, cfg_patch_t patch);
+char *cfg_patch_write(cfg_patch_t patch);
+cfg_patch_t cfg_patch_read(char *source);
+uint8_t *cfg_patch_write_binary(cfg_patch_t patch, uint64_t *size);
+cfg_patch_t cfg_patch_read_binary(uint8_t *buffer, uint64_t size);
+void cfg_patch_free(cfg_patch_t *patch);
+
+// Binding
+uint32_t cfg_bind(char *source, char *section, cfg_schema_t *schema, void *out, uint32_t capacity);
+uint32_t cfg_bind_file(char *path, char *section, cfg_schema_t *schema, void *out, uint32_t capacity);
+void cfg_bind_free(cfg_schema_t *schema, void *out, uint32_t count);
+
+// Overlays
+uint8_t cfg_overlay_add(cfg_overlay_t *overlay, cfg_data_t data);
+uint8_t cfg_overlay_add_file(cfg_overlay_t *overlay, char *path);
+int64_t cfg_overlay_index(cfg_overlay_t *overlay, char *path);
+uint8_t cfg_overlay_reload(cfg_overlay_t *overlay, uint32_t index);
+void cfg_overlay_invalidate(cfg_overlay_t *overlay);
+cfg_variable_t *cfg_overlay_get(cfg_overlay_t *overlay, char *section, char *name);
+cfg_variable_t *cfg_overlay_get_hash(cfg_overlay_t *overlay, uint64_t section, uint64_t name);
+cfg_data_t cfg_overlay_merge(cfg_overlay_t *overlay);
+void cfg_overlay_free(cfg_overlay_t *overlay);
+
+// Frozen documents
+cfg_frozen_t cfg_data_freeze(cfg_data_t *data);
+cfg_data_t cfg_frozen_thaw(cfg_frozen_t *frozen);
+cfg_frozen_section_t *cfg_frozen_section_get(cfg_frozen_t *frozen, char *name);
+cfg_frozen_section_t *cfg_frozen_section_get_hash(cfg_frozen_t *frozen, uint64_t hash);
+cfg_frozen_variable_t *cfg_frozen_variable_get(cfg_frozen_t *frozen, cfg_frozen_section_t *section, char *name);
+cfg_frozen_variable_t *cfg_frozen_variable_get_hash(cfg_frozen_t *frozen, cfg_frozen_section_t *section, uint64_t hash);
+char *cfg_frozen_string(cfg_frozen_t *frozen, uint32_t offset);
+cfg_value_t cfg_frozen_value_get(cfg_frozen_t *frozen, cfg_frozen_value_t value);
+cfg_frozen_list_t *cfg_frozen_list_get(cfg_frozen_t *frozen, cfg_frozen_value_t value);
+void cfg_frozen_free(cfg_frozen_t *frozen);
+
+// Memory usage
+cfg_memory_usage_t cfg_data_memory_usage(cfg_data_t *data);
+cfg_memory_usage_t cfg_frozen_memory_usage(cfg_frozen_t *frozen);
+
+#ifdef __cplusplus
+}
+#endif
+
 #ifdef CFG_IMPLEMENTATION
 
+#include <errno.h>
+#include <float.h>
+
+// Define CFG_THREADS to the number of POSIX threads cfg_data_read_files uses, 0 for one per online processor.
+// Without it batches are read on the calling thread, and nothing beyond the C standard library is needed
+#ifdef CFG_THREADS
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#endif
+
 // Internal data structures
 typedef enum _cfg_token_type _cfg_token_type_t;
 typedef struct _cfg_token _cfg_token_t;
@@ -180,13 +384,74 @@ static char *_cfg_string_append_char(char *string, char c) {
     return temp;
 }
 
+// Returns NULL and leaves errno set if the file cannot be read
+static char *_cfg_file_read(char *path) {
+	FILE *f = fopen(path, "rb");
+	if (!f)
+		return NULL;
+
+	// Read until a short read instead of trusting ftell, which fails for pipes and directories
+	char *source = NULL;
+	uint64_t size = 0, capacity = 0;
+	do {
+		if (size == capacity) {
+			capacity = capacity ? capacity * 2 : 4096;
+			source = realloc(source, capacity + 1);
+		}
+		size += fread(source + size, 1, capacity - size, f);
+	} while (size == capacity);
+
+	if (ferror(f)) {
+		int32_t error = errno;
+		fclose(f);
+		free(source);
+		errno = error;
+		return NULL;
+	}
+	fclose(f);
+
+	source[size] = 0;
+	return source;
+}
+
+// Writes the fewest decimals that read back as the same double. The tokenizer knows no exponents and needs the
+// point to tell floats from ints, so it is always "%.*f". Infinities and NaN have no spelling either, they are
+// written as the largest finite double of the same sign and as 0.0
+static char *_cfg_float_write(char *buffer, double value) {
+	if (value != value)
+		value = 0;
+	else if (value > DBL_MAX)
+		value = DBL_MAX;
+	else if (value < -DBL_MAX)
+		value = -DBL_MAX;
+
+	// 17 significant digits always read back, often 15 or 16 already do
+	char digits[32];
+	for (int32_t precision = 15; precision <= 17; ++precision) {
+		snprintf(digits, sizeof(digits), "%.*e", precision - 1, value);
+		if (strtod(digits, NULL) == value)
+			break;
+	}
+
+	// Trailing zeros of the mantissa are not significant, the exponent places the last digit that is
+	char *exponent = strchr(digits, 'e');
+	char *last = exponent - 1;
+	while (*last == '0')
+		--last;
+	int32_t significant = 0;
+	for (char *c = digits; c <= last; ++c)
+		significant += *c >= '0' && *c <= '9';
+	int32_t decimals = significant - 1 - atoi(exponent + 1);
+	return _cfg_string_append(buffer, "%.*f", decimals > 1 ? decimals : 1, value);
+}
+
 static char *_cfg_value_write(char *buffer, cfg_value_t value) {
 	switch (value.type) {
 	case CFG_INT:
-		buffer = _cfg_string_append(buffer, "%lu", value.value_int);
+		buffer = _cfg_string_append(buffer, "%d", value.value_int);
 		break;
 	case CFG_FLOAT:
-		buffer = _cfg_string_append(buffer, "%f", value.value_float);
+		buffer = _cfg_float_write(buffer, value.value_float);
 		break;
 	case CFG_STRING:
 		buffer = _cfg_string_append(buffer, "\"%s\"", value.value_string);
@@ -209,18 +474,18 @@ static char *_cfg_value_write(char *buffer, cfg_value_t value) {
 	return buffer;
 }
 
-static uint32_t _cfg_token_type(char c) {
-	static uint32_t ignore = 0;
-	if (ignore) {
-		if (ignore == _CFG_TOKEN_STRING && c == '"') {
-			ignore = 0;
+// ignore holds the state of strings, section names and comments, which span several characters
+static uint32_t _cfg_token_type(char c, uint32_t *ignore) {
+	if (*ignore) {
+		if (*ignore == _CFG_TOKEN_STRING && c == '"') {
+			*ignore = 0;
 			return _CFG_TOKEN_QUOTATION;
-		} if (ignore == _CFG_TOKEN_SECTION && c == ']') {
-			ignore = 0;
+		} if (*ignore == _CFG_TOKEN_SECTION && c == ']') {
+			*ignore = 0;
 			return _CFG_TOKEN_SECTION_END;
-		} else if (ignore == _CFG_TOKEN_COMMENT && c == '\n')
-			ignore = 0;
-		return ignore;
+		} else if (*ignore == _CFG_TOKEN_COMMENT && c == '\n')
+			*ignore = 0;
+		return *ignore;
 	}
 
 	if (c <= ' ')
@@ -231,13 +496,13 @@ static uint32_t _cfg_token_type(char c) {
 
 	switch (c) {
 	case '"':
-		ignore = _CFG_TOKEN_STRING;
+		*ignore = _CFG_TOKEN_STRING;
 		return _CFG_TOKEN_QUOTATION;
 	case '[':
-		ignore = _CFG_TOKEN_SECTION;
+		*ignore = _CFG_TOKEN_SECTION;
 		return _CFG_TOKEN_SECTION_BEGIN;
 	case '#':
-		ignore = _CFG_TOKEN_COMMENT;
+		*ignore = _CFG_TOKEN_COMMENT;
 		return _CFG_TOKEN_COMMENT;
 	case '.':
 		return _CFG_TOKEN_FLOAT;
@@ -258,10 +523,11 @@ static _cfg_token_t *_cfg_tokenize(char *source) {
 	_cfg_token_t *full = calloc(1, sizeof(_cfg_token_t)), *root = full;
 	full->type = _CFG_TOKEN_ROOT;
 	uint8_t split = 0;
+	uint32_t ignore = 0;
 
-	for (uint64_t i = 0; i < strlen(source); ++i) {
+	for (uint64_t i = 0, length = strlen(source); i < length; ++i) {
 		char c = source[i];
-		uint32_t type = _cfg_token_type(c);
+		uint32_t type = _cfg_token_type(c, &ignore);
 
 		if (type == _CFG_TOKEN_WHITESPACE ||
 		    type == _CFG_TOKEN_QUOTATION ||
@@ -294,6 +560,16 @@ static _cfg_token_t *_cfg_tokenize(char *source) {
 	return root;
 }
 
+static void _cfg_tokens_free(_cfg_token_t *root) {
+	for (_cfg_token_t *token = root; token != NULL;) {
+		_cfg_token_t *t = token;
+		token = token->next;
+		if (t->string)
+			free(t->string);
+		free(t);
+	}
+}
+
 static cfg_value_t _cfg_token_value(_cfg_token_t **token) {
 	cfg_value_t value = { 0 };
 	const uint64_t true_hash = cfg_hash("true");
@@ -332,226 +608,992 @@ static cfg_value_t _cfg_token_value(_cfg_token_t **token) {
 	return value;
 }
 
-// FNV hash
-uint64_t cfg_hash(char *string) {
-	uint64_t hash = 14695981039346656037ULL; // FNV offset basis
-	int32_t c;
-	while ((c = *string++)) {
-		hash ^= (uint64_t)c;
-		hash *= 1099511628211ULL; // FNV prime
+// Moves past the same tokens as _cfg_token_value without building the value
+static void _cfg_token_skip(_cfg_token_t **token) {
+	if (!*token || (*token)->type != _CFG_TOKEN_LIST_BEGIN)
+		return;
+	while ((*token)->next != NULL) {
+		*token = (*token)->next;
+		if ((*token)->type == _CFG_TOKEN_LIST_END)
+			break;
+		_cfg_token_skip(token);
 	}
-	return hash;
 }
 
-// Sections
-cfg_section_t *cfg_section_add(cfg_data_t *data, char *name, uint32_t index, uint32_t tag_count, char **tags) {
-	if (index > data->count)
-		index = data->count;
-	++data->count;
-
-	data->sections = realloc(data->sections, sizeof(cfg_section_t) * data->count);
-	if (index < data->count - 1)
-		memcpy(&data->sections[index + 1], &data->sections[index], sizeof(cfg_section_t) * (data->count - index - 1));
-
-	cfg_section_t *curr = &data->sections[index];
-
-	if (name)
-		curr->name = _cfg_string_copy(name);
-	else
-		curr->name = _cfg_string_append(NULL, "section%u", data->count);
-	curr->count = 0;
-	curr->variables = NULL;
-	curr->tag_count = tag_count;
-	curr->tags = tags;
+static cfg_list_t *_cfg_list_clone(cfg_list_t *list);
 
-	return curr;
+// Deep copy of a value, the copy owns its string or list
+static cfg_value_t _cfg_value_clone(cfg_value_t value) {
+	if (value.type == CFG_STRING && value.value_string)
+		value.value_string = _cfg_string_copy(value.value_string);
+	else if (value.type == CFG_LIST && value.value_list)
+		value.value_list = _cfg_list_clone(value.value_list);
+	return value;
 }
 
-cfg_section_t *cfg_section_get(cfg_data_t *data, char *name) {
-	uint64_t hash = cfg_hash(name);
-	for (uint32_t i = 0; i < data->count; ++i) {
-		uint64_t h = cfg_hash(data->sections[i].name);
-		if (hash == h)
-			return &data->sections[i];
+static cfg_list_t *_cfg_list_clone(cfg_list_t *list) {
+	cfg_list_t *copy = cfg_list_create();
+	if (list->count) {
+		copy->count = list->count;
+		copy->values = malloc(sizeof(cfg_value_t) * list->count);
+		for (uint32_t i = 0; i < list->count; ++i)
+			copy->values[i] = _cfg_value_clone(list->values[i]);
 	}
-	return NULL;
+	return copy;
 }
 
-int64_t cfg_section_index(cfg_data_t *data, char *name) {
-	uint64_t hash = cfg_hash(name);
-	for (uint32_t i = 0; i < data->count; ++i) {
-		uint64_t h = cfg_hash(data->sections[i].name);
-		if (hash == h)
-			return i;
-	}
-	return -1;
+static void _cfg_value_free(cfg_value_t *value) {
+	if (value->type == CFG_STRING && value->value_string)
+		free(value->value_string);
+	else if (value->type == CFG_LIST && value->value_list)
+		cfg_list_delete(value->value_list);
+	value->value = NULL;
 }
 
-uint32_t cfg_section_pointer_index(cfg_data_t *data, cfg_section_t *section) {
-	return data->sections - section;
+static uint8_t _cfg_value_equal(cfg_value_t a, cfg_value_t b) {
+	if (a.type != b.type)
+		return 0;
+	switch (a.type) {
+	case CFG_INT:
+		return a.value_int == b.value_int;
+	case CFG_FLOAT:
+		return a.value_float == b.value_float;
+	case CFG_STRING:
+		return !strcmp(a.value_string ? a.value_string : "", b.value_string ? b.value_string : "");
+	case CFG_BOOL:
+		return !a.value_bool == !b.value_bool;
+	case CFG_LIST:
+		if (a.value_list->count != b.value_list->count)
+			return 0;
+		for (uint32_t i = 0; i < a.value_list->count; ++i) {
+			if (!_cfg_value_equal(a.value_list->values[i], b.value_list->values[i]))
+				return 0;
+		}
+		return 1;
+	default:
+		return 1;
+	}
 }
 
-void cfg_section_remove(cfg_data_t *data, uint32_t index) {
-	if (index > data->count - 1)
-		return;
-	--data->count;
-
-	cfg_section_t *curr = &data->sections[index];
+// Patch internals
+static char *_cfg_patch_op_names[] = {
+	"@section_add",
+	"@section_remove",
+	"@section_tags",
+	"@variable_add",
+	"@variable_remove",
+	"@variable_change",
+	"@list_add",
+	"@list_remove",
+	"@list_change"
+};
 
-	if (curr->name)
-		free(curr->name);
-	if (curr->tags)
-		free(curr->tags);
-	if (curr->variables) {
-		for (uint32_t i = 0; i < curr->count; ++i)
-			cfg_variable_remove(curr, i);
-		free(curr->variables);
+static void _cfg_patch_push(cfg_patch_t *patch, cfg_patch_op_t op, char *section, uint32_t section_occurrence,
+                            char *variable, uint32_t variable_occurrence,
+                            uint32_t index, uint32_t depth, uint32_t *path, cfg_value_t value) {
+	++patch->count;
+	patch->entries = realloc(patch->entries, sizeof(cfg_patch_entry_t) * patch->count);
+
+	cfg_patch_entry_t *curr = &patch->entries[patch->count - 1];
+	curr->op = op;
+	curr->section = _cfg_string_copy(section);
+	curr->variable = variable ? _cfg_string_copy(variable) : NULL;
+	curr->section_occurrence = section_occurrence;
+	curr->variable_occurrence = variable_occurrence;
+	curr->index = index;
+	curr->depth = depth;
+	curr->path = NULL;
+	if (depth) {
+		curr->path = malloc(sizeof(uint32_t) * depth);
+		memcpy(curr->path, path, sizeof(uint32_t) * depth);
 	}
-
-	if (index < data->count)
-		memcpy(curr, &data->sections[index + 1], sizeof(cfg_section_t) * (data->count - index));
-
-	data->sections = realloc(data->sections, sizeof(cfg_section_t) * data->count);
+	curr->value = _cfg_value_clone(value);
 }
 
-// Lists
-cfg_list_t *cfg_list_create() {
-	cfg_list_t *list = malloc(sizeof(cfg_list_t));
-	list->count = 0;
-	list->values = NULL;
-	return list;
+// Tags are carried as a list of strings in the value of section operations
+static void _cfg_patch_push_section(cfg_patch_t *patch, cfg_patch_op_t op, cfg_section_t *section,
+                                    uint32_t occurrence, uint32_t index) {
+	cfg_value_t tags = { CFG_LIST, { .value_list = cfg_list_create() } };
+	for (uint32_t t = 0; t < section->tag_count; ++t)
+		cfg_list_add(tags.value_list, (cfg_value_t) { CFG_STRING, { .value_string = section->tags[t] } }, t);
+	_cfg_patch_push(patch, op, section->name, occurrence, NULL, 0, index, 0, NULL, tags);
+	cfg_list_delete(tags.value_list);
 }
 
-void cfg_list_delete(cfg_list_t *list) {
-	if (list->values) {
-		for (uint32_t i = 0; i < list->count; ++i) {
-			if (list->values[i].type == CFG_STRING && list->values[i].value_string)
-				free(list->values[i].value_string);
-			else if (list->values[i].type == CFG_LIST && list->values[i].value_list)
-				cfg_list_delete(list->values[i].value_list);
-		}
-		free(list->values);
+static uint8_t _cfg_tags_equal(cfg_section_t *a, cfg_section_t *b) {
+	if (a->tag_count != b->tag_count)
+		return 0;
+	for (uint32_t t = 0; t < a->tag_count; ++t) {
+		if (strcmp(a->tags[t], b->tags[t]))
+			return 0;
 	}
-	free(list);
+	return 1;
 }
 
-cfg_value_t *cfg_list_add(cfg_list_t *list, cfg_value_t value, uint32_t index) {
-	if (index > list->count)
-		index = list->count;
-	++list->count;
-	
-	list->values = realloc(list->values, sizeof(cfg_value_t) * list->count);
-	if (index < list->count - 1)
-		memcpy(&list->values[index + 1], &list->values[index], sizeof(cfg_value_t) * (list->count - index - 1));
+// Names may repeat, so sections and variables are matched by name and occurrence, the number of earlier ones with
+// the same name. The buffers are reused for every section of a diff
+typedef struct _cfg_occurrences _cfg_occurrences_t;
 
-	cfg_value_t *curr = &list->values[index];
-	memcpy(curr, &value, sizeof(cfg_value_t));
-	if (value.type == CFG_STRING) {
-		if (value.value_string)
-			curr->value_string = _cfg_string_copy(value.value_string);
-		else
-			curr->value_string = "";
-	}
+struct _cfg_occurrences {
+	uint32_t *occurrences;
+	uint64_t *keys;
+	uint32_t *seen; // Occurrences so far by hash, 0 for empty slots
+	uint32_t capacity, slots;
+};
 
-	return curr;
+// hashes holds count name hashes, stride bytes apart
+static uint32_t *_cfg_occurrences_count(_cfg_occurrences_t *buffers, uint64_t *hashes, uint32_t count, uint64_t stride) {
+	uint32_t slots = 16;
+	while (slots < count * 2)
+		slots *= 2;
+	if (count > buffers->capacity) {
+		buffers->capacity = count;
+		buffers->occurrences = realloc(buffers->occurrences, sizeof(uint32_t) * count);
+	}
+	if (slots > buffers->slots) {
+		buffers->slots = slots;
+		buffers->keys = realloc(buffers->keys, sizeof(uint64_t) * slots);
+		buffers->seen = realloc(buffers->seen, sizeof(uint32_t) * slots);
+	}
+	memset(buffers->seen, 0, sizeof(uint32_t) * slots);
+
+	for (uint32_t i = 0; i < count; ++i) {
+		uint64_t hash = *(uint64_t *)((uint8_t *)hashes + stride * i);
+		uint32_t slot = hash & (slots - 1);
+		while (buffers->seen[slot] && buffers->keys[slot] != hash)
+			slot = (slot + 1) & (slots - 1);
+		buffers->keys[slot] = hash;
+		buffers->occurrences[i] = buffers->seen[slot]++;
+	}
+	return buffers->occurrences;
 }
 
-void cfg_list_remove(cfg_list_t *list, uint32_t index) {
-	if (index > list->count - 1)
-		return;
-	--list->count;
-
-	cfg_value_t *curr = &list->values[index];
-
-	if (curr->type == CFG_STRING && curr->value_string)
-		free(curr->value_string);
-	else if (curr->type == CFG_LIST && curr->value_list)
-		cfg_list_delete(curr->value_list);
-
-	if (index < list->count)
-		memcpy(curr, &list->values[index + 1], sizeof(cfg_value_t) * (list->count - index));
-
-	list->values = realloc(list->values, sizeof(cfg_value_t) * list->count);
+static void _cfg_occurrences_free(_cfg_occurrences_t *buffers) {
+	free(buffers->occurrences);
+	free(buffers->keys);
+	free(buffers->seen);
 }
 
-// Variables
-cfg_variable_t *cfg_variable_add(cfg_section_t *section, char *name, cfg_value_t value, uint32_t index) {
-	if (index > section->count)
-		index = section->count;
-	++section->count;
-	
-	section->variables = realloc(section->variables, sizeof(cfg_variable_t) * section->count);
-	if (index < section->count - 1)
-		memcpy(&section->variables[index + 1], &section->variables[index], sizeof(cfg_variable_t) * (section->count - index - 1));
-
-	cfg_variable_t *curr = &section->variables[index];
-
-	if (name)
-		curr->name = _cfg_string_copy(name);
-	else
-		curr->name = _cfg_string_append(NULL, "var%u", section->count);
-
-	curr->value = value;
-	if (value.type == CFG_STRING) {
-		if (value.value_string)
-			curr->value.value_string = _cfg_string_copy(value.value_string);
-		else
-			curr->value.value_string = "";
+// Unchanged documents keep their order, so the same index is tried before searching
+static cfg_section_t *_cfg_section_find(cfg_data_t *data, uint32_t *occurrences, uint64_t hash, uint32_t occurrence, uint32_t hint) {
+	if (hint < data->count && data->sections[hint].hash == hash && occurrences[hint] == occurrence)
+		return &data->sections[hint];
+	for (uint32_t i = 0; i < data->count; ++i) {
+		if (data->sections[i].hash == hash && occurrences[i] == occurrence)
+			return &data->sections[i];
 	}
-
-	return curr;
+	return NULL;
 }
 
-cfg_variable_t *cfg_variable_get(cfg_section_t *section, char *name) {
-	uint64_t hash = cfg_hash(name);
+static cfg_variable_t *_cfg_variable_find(cfg_section_t *section, uint32_t *occurrences, uint64_t hash, uint32_t occurrence, uint32_t hint) {
+	if (hint < section->count && section->variables[hint].hash == hash && occurrences[hint] == occurrence)
+		return &section->variables[hint];
 	for (uint32_t i = 0; i < section->count; ++i) {
-		uint64_t h = cfg_hash(section->variables[i].name);
-		if (hash == h)
+		if (section->variables[i].hash == hash && occurrences[i] == occurrence)
 			return &section->variables[i];
 	}
 	return NULL;
 }
 
-int64_t cfg_variable_index(cfg_section_t *section, char *name) {
-	uint64_t hash = cfg_hash(name);
-	for (uint32_t i = 0; i < section->count; ++i) {
-		uint64_t h = cfg_hash(section->variables[i].name);
-		if (hash == h)
-			return i;
+// The same lookups for documents that change while a patch is applied, counting instead of using occurrences
+static cfg_section_t *_cfg_section_nth(cfg_data_t *data, uint64_t hash, uint32_t occurrence) {
+	for (uint32_t i = 0; i < data->count; ++i) {
+		if (data->sections[i].hash == hash && !occurrence--)
+			return &data->sections[i];
 	}
-	return -1;
+	return NULL;
 }
 
-uint32_t cfg_variable_pointer_index(cfg_section_t *section, cfg_variable_t *variable) {
-	return section->variables - variable;
+static cfg_variable_t *_cfg_variable_nth(cfg_section_t *section, uint64_t hash, uint32_t occurrence) {
+	for (uint32_t i = 0; i < section->count; ++i) {
+		if (section->variables[i].hash == hash && !occurrence--)
+			return &section->variables[i];
+	}
+	return NULL;
 }
 
-void cfg_variable_remove(cfg_section_t *section, uint32_t index) {
-	if (index > section->count - 1)
-		return;
-	--section->count;
+// target names the section and variable that hold the lists
+static void _cfg_patch_diff_list(cfg_patch_t *patch, cfg_patch_entry_t *target,
+                                 uint32_t depth, uint32_t *path, cfg_list_t *from, cfg_list_t *to) {
+	cfg_value_t none = { 0 };
+	uint32_t common = from->count < to->count ? from->count : to->count;
+	uint32_t *sub = malloc(sizeof(uint32_t) * (depth + 1));
+	if (depth)
+		memcpy(sub, path, sizeof(uint32_t) * depth);
+
+	for (uint32_t i = 0; i < common; ++i) {
+		cfg_value_t a = from->values[i], b = to->values[i];
+		if (_cfg_value_equal(a, b))
+			continue;
+		sub[depth] = i;
+		if (a.type == CFG_LIST && b.type == CFG_LIST)
+			_cfg_patch_diff_list(patch, target, depth + 1, sub, a.value_list, b.value_list);
+		else
+			_cfg_patch_push(patch, CFG_PATCH_LIST_CHANGE, target->section, target->section_occurrence,
+			                target->variable, target->variable_occurrence, 0, depth + 1, sub, b);
+	}
+	for (uint32_t i = common; i < to->count; ++i) {
+		sub[depth] = i;
+		_cfg_patch_push(patch, CFG_PATCH_LIST_ADD, target->section, target->section_occurrence,
+		                target->variable, target->variable_occurrence, 0, depth + 1, sub, to->values[i]);
+	}
+	// Remove from the back, so the indices stay valid while the patch is applied
+	for (uint32_t i = from->count; i > common; --i) {
+		sub[depth] = i - 1;
+		_cfg_patch_push(patch, CFG_PATCH_LIST_REMOVE, target->section, target->section_occurrence,
+		                target->variable, target->variable_occurrence, 0, depth + 1, sub, none);
+	}
 
-	cfg_variable_t *curr = &section->variables[index];
+	free(sub);
+}
 
-	if (curr->name)
-		free(curr->name);
+// Binary patches are stored in native byte order
+typedef struct _cfg_buffer _cfg_buffer_t;
 
-	if (curr->value.type == CFG_STRING && curr->value.value_string)
-		free(curr->value.value_string);
-	else if (curr->value.type == CFG_LIST && curr->value.value_list)
-		cfg_list_delete(curr->value.value_list);
+struct _cfg_buffer {
+	uint8_t *data;
+	uint64_t size, capacity;
+};
 
-	if (index < section->count)
-		memcpy(curr, &section->variables[index + 1], sizeof(cfg_variable_t) * (section->count - index));
+static void _cfg_buffer_write(_cfg_buffer_t *buffer, void *data, uint64_t size) {
+	if (buffer->size + size > buffer->capacity) {
+		while (buffer->size + size > buffer->capacity)
+			buffer->capacity = buffer->capacity ? buffer->capacity * 2 : 256;
+		buffer->data = realloc(buffer->data, buffer->capacity);
+	}
+	memcpy(buffer->data + buffer->size, data, size);
+	buffer->size += size;
+}
 
-	section->variables = realloc(section->variables, sizeof(cfg_variable_t) * section->count);
+static void _cfg_buffer_write_string(_cfg_buffer_t *buffer, char *string) {
+	uint32_t length = string ? strlen(string) : UINT32_MAX;
+	_cfg_buffer_write(buffer, &length, sizeof(uint32_t));
+	if (string)
+		_cfg_buffer_write(buffer, string, length);
 }
 
-// Data
-char *cfg_data_write(cfg_data_t data) {
-	char *buffer = NULL;
-	for (uint32_t s = 0; s < data.count; ++s) {
-		cfg_section_t *section = &data.sections[s];
+static void _cfg_buffer_write_value(_cfg_buffer_t *buffer, cfg_value_t value) {
+	uint8_t type = value.type;
+	_cfg_buffer_write(buffer, &type, 1);
+	switch (value.type) {
+	case CFG_INT:
+		_cfg_buffer_write(buffer, &value.value_int, sizeof(int32_t));
+		break;
+	case CFG_FLOAT:
+		_cfg_buffer_write(buffer, &value.value_float, sizeof(double));
+		break;
+	case CFG_STRING:
+		_cfg_buffer_write_string(buffer, value.value_string);
+		break;
+	case CFG_BOOL:
+		_cfg_buffer_write(buffer, &value.value_bool, 1);
+		break;
+	case CFG_LIST:
+		_cfg_buffer_write(buffer, &value.value_list->count, sizeof(uint32_t));
+		for (uint32_t i = 0; i < value.value_list->count; ++i)
+			_cfg_buffer_write_value(buffer, value.value_list->values[i]);
+		break;
+	default:
+		break;
+	}
+}
+
+static uint8_t _cfg_buffer_read(_cfg_buffer_t *buffer, void *data, uint64_t size) {
+	if (size > buffer->capacity - buffer->size)
+		return 0;
+	memcpy(data, buffer->data + buffer->size, size);
+	buffer->size += size;
+	return 1;
+}
+
+static uint8_t _cfg_buffer_read_string(_cfg_buffer_t *buffer, char **string) {
+	uint32_t length;
+	*string = NULL;
+	if (!_cfg_buffer_read(buffer, &length, sizeof(uint32_t)))
+		return 0;
+	if (length == UINT32_MAX)
+		return 1;
+	if (length > buffer->capacity - buffer->size)
+		return 0;
+	*string = malloc(length + 1);
+	_cfg_buffer_read(buffer, *string, length);
+	(*string)[length] = 0;
+	return 1;
+}
+
+static uint8_t _cfg_buffer_read_value(_cfg_buffer_t *buffer, cfg_value_t *value) {
+	uint8_t type;
+	*value = (cfg_value_t) { 0 };
+	if (!_cfg_buffer_read(buffer, &type, 1))
+		return 0;
+
+	switch (type) {
+	case CFG_INT:
+		value->type = CFG_INT;
+		return _cfg_buffer_read(buffer, &value->value_int, sizeof(int32_t));
+	case CFG_FLOAT:
+		value->type = CFG_FLOAT;
+		return _cfg_buffer_read(buffer, &value->value_float, sizeof(double));
+	case CFG_STRING:
+		value->type = CFG_STRING;
+		return _cfg_buffer_read_string(buffer, &value->value_string);
+	case CFG_BOOL:
+		value->type = CFG_BOOL;
+		return _cfg_buffer_read(buffer, &value->value_bool, 1);
+	case CFG_LIST: {
+		uint32_t count;
+		if (!_cfg_buffer_read(buffer, &count, sizeof(uint32_t)))
+			return 0;
+		// Every value takes at least one byte, larger counts can only come from a corrupt buffer
+		if (count > buffer->capacity - buffer->size)
+			return 0;
+		value->type = CFG_LIST;
+		value->value_list = cfg_list_create();
+		if (count)
+			value->value_list->values = malloc(sizeof(cfg_value_t) * count);
+		for (uint32_t i = 0; i < count; ++i) {
+			uint8_t ok = _cfg_buffer_read_value(buffer, &value->value_list->values[i]);
+			value->value_list->count = i + 1;
+			if (!ok)
+				return 0;
+		}
+		return 1;
+	}
+	default:
+		return 0;
+	}
+}
+
+// Batch internals
+typedef struct _cfg_batch _cfg_batch_t;
+
+struct _cfg_batch {
+	char **paths;
+	uint32_t count;
+	cfg_file_result_t *out;
+#ifdef CFG_THREADS
+	atomic_uint next;
+#else
+	uint32_t next;
+#endif
+};
+
+static void *_cfg_batch_worker(void *argument) {
+	_cfg_batch_t *batch = argument;
+
+	// Files are taken one at a time, so the reads of some workers overlap the parsing of others
+	for (;;) {
+#ifdef CFG_THREADS
+		uint32_t i = atomic_fetch_add(&batch->next, 1);
+#else
+		uint32_t i = batch->next++;
+#endif
+		if (i >= batch->count)
+			break;
+
+		cfg_file_result_t *curr = &batch->out[i];
+		curr->data = (cfg_data_t) { 0 };
+		errno = 0;
+		char *source = _cfg_file_read(batch->paths[i]);
+		if (!source) {
+			curr->error = errno ? errno : EIO;
+			continue;
+		}
+		curr->error = 0;
+		curr->data = cfg_data_read(source);
+		free(source);
+	}
+
+	return NULL;
+}
+
+// Binding internals
+// Stores a copy of value in the member of field, values of another type are ignored and return 0.
+// With take, a list is handed to the member instead of copied
+static uint8_t _cfg_bind_store(cfg_field_t *field, uint8_t *object, cfg_value_t value, uint8_t take) {
+	void *member = object + field->offset;
+	switch (field->type) {
+	case CFG_INT:
+		if (value.type != CFG_INT)
+			return 0;
+		*(int32_t *)member = value.value_int;
+		return 1;
+	case CFG_FLOAT:
+		if (value.type == CFG_INT)
+			*(double *)member = value.value_int;
+		else if (value.type == CFG_FLOAT)
+			*(double *)member = value.value_float;
+		else
+			return 0;
+		return 1;
+	case CFG_STRING:
+		if (value.type != CFG_STRING)
+			return 0;
+		free(*(char **)member);
+		*(char **)member = value.value_string ? _cfg_string_copy(value.value_string) : NULL;
+		return 1;
+	case CFG_BOOL:
+		if (value.type != CFG_BOOL)
+			return 0;
+		*(uint8_t *)member = value.value_bool;
+		return 1;
+	case CFG_LIST:
+		if (value.type != CFG_LIST)
+			return 0;
+		if (*(cfg_list_t **)member)
+			cfg_list_delete(*(cfg_list_t **)member);
+		*(cfg_list_t **)member = value.value_list && !take ? _cfg_list_clone(value.value_list) : value.value_list;
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+// Starts a section, returns the struct it binds to or NULL if it is not bound
+static uint8_t *_cfg_bind_section(cfg_schema_t *schema, uint8_t *out, uint32_t capacity, uint32_t *bound,
+                                  uint64_t filter, char *name, uint32_t index) {
+	if (*bound >= capacity)
+		return NULL;
+
+	if (filter) {
+		// Unnamed sections get the same automatic names as in cfg_data_read
+		uint64_t hash;
+		if (name) {
+			hash = cfg_hash(name);
+		} else {
+			char *automatic = _cfg_string_append(NULL, "section%u", index);
+			hash = cfg_hash(automatic);
+			free(automatic);
+		}
+		if (hash != filter)
+			return NULL;
+	}
+
+	static const uint32_t sizes[] = { sizeof(int32_t), sizeof(double), sizeof(char *), sizeof(uint8_t), sizeof(cfg_list_t *) };
+	uint8_t *object = out + (uint64_t)schema->size * (*bound)++;
+	for (uint32_t f = 0; f < schema->count; ++f) {
+		cfg_field_t *field = &schema->fields[f];
+		// The member may hold garbage, so it is cleared before the default is stored
+		if (field->type <= CFG_LIST)
+			memset(object + field->offset, 0, sizes[field->type]);
+		_cfg_bind_store(field, object, field->value, 0);
+	}
+	return object;
+}
+
+// Overlay internals
+// Resolves path against the directory of base and drops "." and ".." segments,
+// so every spelling of the same included file maps to the same layer
+static char *_cfg_path_resolve(char *base, char *path) {
+	char *slash = base ? strrchr(base, '/') : NULL;
+	char *joined = (path[0] != '/' && slash) ?
+		_cfg_string_append(NULL, "%.*s%s", (int32_t)(slash - base + 1), base, path) :
+		_cfg_string_copy(path);
+
+	char *result = malloc(strlen(joined) + 2);
+	uint64_t size = 0, root = 0;
+	uint32_t depth = 0; // Segments that a ".." can remove
+	if (joined[0] == '/')
+		result[size++] = '/';
+	root = size;
+
+	for (char *segment = joined; *segment;) {
+		char *end = strchr(segment, '/');
+		if (!end)
+			end = segment + strlen(segment);
+		uint64_t length = end - segment;
+
+		if (length == 2 && segment[0] == '.' && segment[1] == '.' && (depth || root)) {
+			if (depth) {
+				while (size > root && result[size - 1] != '/')
+					--size;
+				if (size > root)
+					--size;
+				--depth;
+			}
+		} else if (length && !(length == 1 && segment[0] == '.')) {
+			if (size > root)
+				result[size++] = '/';
+			memcpy(result + size, segment, length);
+			size += length;
+			if (!(length == 2 && segment[0] == '.' && segment[1] == '.'))
+				++depth;
+		}
+
+		segment = *end ? end + 1 : end;
+	}
+	if (!size)
+		result[size++] = '.';
+	result[size] = 0;
+
+	free(joined);
+	return result;
+}
+
+static int64_t _cfg_overlay_find(cfg_overlay_t *overlay, char *path) {
+	uint64_t hash = cfg_hash(path);
+	for (uint32_t i = 0; i < overlay->count; ++i) {
+		if (overlay->layers[i].path && overlay->layers[i].hash == hash)
+			return i;
+	}
+	return -1;
+}
+
+static uint32_t _cfg_overlay_insert(cfg_overlay_t *overlay, uint32_t index, char *path, cfg_data_t data, uint8_t *result);
+
+// Inserts the documents included by the layer at index below it, returns how many layers were inserted
+static uint32_t _cfg_overlay_include(cfg_overlay_t *overlay, uint32_t index, uint8_t *result) {
+	uint32_t inserted = 0;
+	for (uint32_t i = 0; i < overlay->layers[index + inserted].data.include_count; ++i) {
+		cfg_layer_t *layer = &overlay->layers[index + inserted];
+		char *path = _cfg_path_resolve(layer->path, layer->data.includes[i]);
+
+		// Every file is read, parsed and layered once, no matter how many layers include it
+		if (_cfg_overlay_find(overlay, path) >= 0) {
+			free(path);
+			continue;
+		}
+		char *source = _cfg_file_read(path);
+		if (!source) {
+			*result = 0;
+			free(path);
+			continue;
+		}
+		cfg_data_t data = cfg_data_read(source);
+		free(source);
+
+		inserted += _cfg_overlay_insert(overlay, index + inserted, path, data, result);
+	}
+	return inserted;
+}
+
+// Takes ownership of path and data. The layer is inserted before its includes are loaded, so include cycles end
+static uint32_t _cfg_overlay_insert(cfg_overlay_t *overlay, uint32_t index, char *path, cfg_data_t data, uint8_t *result) {
+	++overlay->count;
+	overlay->layers = realloc(overlay->layers, sizeof(cfg_layer_t) * overlay->count);
+	if (index < overlay->count - 1)
+		memmove(&overlay->layers[index + 1], &overlay->layers[index], sizeof(cfg_layer_t) * (overlay->count - index - 1));
+
+	cfg_layer_t *curr = &overlay->layers[index];
+	curr->path = path;
+	curr->hash = path ? cfg_hash(path) : 0;
+	curr->data = data;
+
+	return 1 + _cfg_overlay_include(overlay, index, result);
+}
+
+static inline uint32_t _cfg_overlay_slot(uint64_t section, uint64_t variable) {
+	return (uint32_t)((section ^ (variable * 0x9E3779B97F4A7C15ULL)) >> 32);
+}
+
+static void _cfg_overlay_cache(cfg_overlay_t *overlay, uint64_t section, uint64_t variable, cfg_variable_t *value) {
+	// Grow at 3/4 load, only entries of the current generation are carried over
+	if ((overlay->cache_count + 1) * 4 > overlay->cache_capacity * 3) {
+		uint32_t capacity = overlay->cache_capacity ? overlay->cache_capacity * 2 : 64;
+		cfg_overlay_entry_t *cache = calloc(capacity, sizeof(cfg_overlay_entry_t));
+		for (uint32_t i = 0; i < overlay->cache_capacity; ++i) {
+			cfg_overlay_entry_t *entry = &overlay->cache[i];
+			if (entry->generation != overlay->generation)
+				continue;
+			uint32_t slot = _cfg_overlay_slot(entry->section, entry->variable) & (capacity - 1);
+			while (cache[slot].generation == overlay->generation)
+				slot = (slot + 1) & (capacity - 1);
+			cache[slot] = *entry;
+		}
+		free(overlay->cache);
+		overlay->cache = cache;
+		overlay->cache_capacity = capacity;
+	}
+
+	uint32_t mask = overlay->cache_capacity - 1;
+	uint32_t slot = _cfg_overlay_slot(section, variable) & mask;
+	while (overlay->cache[slot].generation == overlay->generation)
+		slot = (slot + 1) & mask;
+	overlay->cache[slot] = (cfg_overlay_entry_t) { section, variable, overlay->generation, value };
+	++overlay->cache_count;
+}
+
+static char **_cfg_tags_copy(uint32_t count, char **tags) {
+	char **copy = count ? malloc(sizeof(char *) * count) : NULL;
+	for (uint32_t t = 0; t < count; ++t)
+		copy[t] = _cfg_string_copy(tags[t]);
+	return copy;
+}
+
+// Freeze internals
+typedef struct _cfg_freezer _cfg_freezer_t;
+
+struct _cfg_freezer {
+	cfg_frozen_t *frozen;
+	uint32_t variable, value, list, floats; // Next free record of each kind
+	char *pool;
+	uint32_t pool_size, pool_capacity;
+	uint32_t *table; // Offset + 1 of every pooled string by hash, 0 for empty slots
+	uint32_t mask;
+};
+
+// Counts the records a value takes, strings is the number of strings it may add to the pool
+static void _cfg_freeze_count(cfg_frozen_t *frozen, cfg_value_t value, uint32_t *strings) {
+	if (value.type == CFG_FLOAT)
+		++frozen->float_count;
+	else if (value.type == CFG_STRING)
+		++*strings;
+	else if (value.type == CFG_LIST) {
+		++frozen->list_count;
+		if (value.value_list) {
+			frozen->value_count += value.value_list->count;
+			for (uint32_t i = 0; i < value.value_list->count; ++i)
+				_cfg_freeze_count(frozen, value.value_list->values[i], strings);
+		}
+	}
+}
+
+// Adds string to the pool unless it is already there, returns its offset
+static uint32_t _cfg_freeze_string(_cfg_freezer_t *freezer, char *string) {
+	if (!string)
+		string = "";
+	uint32_t slot = cfg_hash(string) & freezer->mask;
+	while (freezer->table[slot]) {
+		if (!strcmp(freezer->pool + freezer->table[slot] - 1, string))
+			return freezer->table[slot] - 1;
+		slot = (slot + 1) & freezer->mask;
+	}
+
+	uint32_t offset = freezer->pool_size, size = strlen(string) + 1;
+	if (offset + size > freezer->pool_capacity) {
+		freezer->pool_capacity = (offset + size) * 2;
+		freezer->pool = realloc(freezer->pool, freezer->pool_capacity);
+	}
+	memcpy(freezer->pool + offset, string, size);
+	freezer->pool_size += size;
+	freezer->table[slot] = offset + 1;
+	return offset;
+}
+
+// List elements take consecutive values, the elements of nested lists are placed after them
+static cfg_frozen_value_t _cfg_freeze_value(_cfg_freezer_t *freezer, cfg_value_t value) {
+	cfg_frozen_t *frozen = freezer->frozen;
+	cfg_frozen_value_t frozen_value = { value.type, { 0 } };
+	switch (value.type) {
+	case CFG_INT:
+		frozen_value.value_int = value.value_int;
+		break;
+	case CFG_FLOAT:
+		frozen->floats[freezer->floats] = value.value_float;
+		frozen_value.value_float = freezer->floats++;
+		break;
+	case CFG_STRING:
+		frozen_value.value_string = _cfg_freeze_string(freezer, value.value_string);
+		break;
+	case CFG_BOOL:
+		frozen_value.value_bool = value.value_bool;
+		break;
+	case CFG_LIST: {
+		cfg_frozen_list_t *list = &frozen->lists[freezer->list];
+		frozen_value.value_list = freezer->list++;
+		list->first = freezer->value;
+		list->count = value.value_list ? value.value_list->count : 0;
+		freezer->value += list->count;
+		for (uint32_t i = 0; i < list->count; ++i) {
+			cfg_frozen_value_t element = _cfg_freeze_value(freezer, value.value_list->values[i]);
+			frozen->values[list->first + i] = element;
+		}
+		break;
+	}
+	}
+	return frozen_value;
+}
+
+// Points the arrays of frozen into block, ordered by alignment, returns the offset of the string pool
+static uint64_t _cfg_frozen_layout(cfg_frozen_t *frozen, uint8_t *block) {
+	uint64_t offset = 0;
+	frozen->sections = (cfg_frozen_section_t *)block;
+	offset += sizeof(cfg_frozen_section_t) * frozen->count;
+	frozen->variables = (cfg_frozen_variable_t *)(block + offset);
+	offset += sizeof(cfg_frozen_variable_t) * frozen->variable_count;
+	frozen->floats = (double *)(block + offset);
+	offset += sizeof(double) * frozen->float_count;
+	frozen->values = (cfg_frozen_value_t *)(block + offset);
+	offset += sizeof(cfg_frozen_value_t) * frozen->value_count;
+	frozen->lists = (cfg_frozen_list_t *)(block + offset);
+	offset += sizeof(cfg_frozen_list_t) * frozen->list_count;
+	frozen->tags = (uint32_t *)(block + offset);
+	offset += sizeof(uint32_t) * frozen->tag_count;
+	frozen->includes = (uint32_t *)(block + offset);
+	offset += sizeof(uint32_t) * frozen->include_count;
+	frozen->strings = (char *)(block + offset);
+	return offset;
+}
+
+static uint64_t _cfg_frozen_size(cfg_frozen_t *frozen) {
+	return sizeof(cfg_frozen_section_t) * frozen->count + sizeof(cfg_frozen_variable_t) * frozen->variable_count +
+	       sizeof(double) * frozen->float_count + sizeof(cfg_frozen_value_t) * frozen->value_count +
+	       sizeof(cfg_frozen_list_t) * frozen->list_count + sizeof(uint32_t) * (frozen->tag_count + frozen->include_count);
+}
+
+// Builds an owned value, strings stay in the pool since cfg_variable_add and cfg_list_add copy them
+static cfg_value_t _cfg_thaw_value(cfg_frozen_t *frozen, cfg_frozen_value_t value) {
+	cfg_value_t thawed = cfg_frozen_value_get(frozen, value);
+	if (value.type == CFG_LIST) {
+		cfg_frozen_list_t *list = &frozen->lists[value.value_list];
+		thawed.value_list = cfg_list_create();
+		for (uint32_t i = 0; i < list->count; ++i)
+			cfg_list_add(thawed.value_list, _cfg_thaw_value(frozen, frozen->values[list->first + i]), i);
+	}
+	return thawed;
+}
+
+// Memory usage internals
+static void _cfg_memory_string(cfg_memory_usage_t *usage, char *string) {
+	if (!string)
+		return;
+	usage->strings += strlen(string) + 1;
+	++usage->allocations;
+}
+
+static void _cfg_memory_value(cfg_memory_usage_t *usage, cfg_value_t value) {
+	if (value.type == CFG_STRING)
+		_cfg_memory_string(usage, value.value_string);
+	else if (value.type == CFG_LIST && value.value_list) {
+		usage->values += sizeof(cfg_list_t) + sizeof(cfg_value_t) * value.value_list->count;
+		usage->allocations += value.value_list->count ? 2 : 1;
+		for (uint32_t i = 0; i < value.value_list->count; ++i)
+			_cfg_memory_value(usage, value.value_list->values[i]);
+	}
+}
+
+// FNV hash
+uint64_t cfg_hash(char *string) {
+	uint64_t hash = 14695981039346656037ULL; // FNV offset basis
+	int32_t c;
+	while ((c = *string++)) {
+		hash ^= (uint64_t)c;
+		hash *= 1099511628211ULL; // FNV prime
+	}
+	return hash;
+}
+
+// Sections
+cfg_section_t *cfg_section_add(cfg_data_t *data, char *name, uint32_t index, uint32_t tag_count, char **tags) {
+	if (index > data->count)
+		index = data->count;
+	++data->count;
+
+	data->sections = realloc(data->sections, sizeof(cfg_section_t) * data->count);
+	if (index < data->count - 1)
+		memmove(&data->sections[index + 1], &data->sections[index], sizeof(cfg_section_t) * (data->count - index - 1));
+
+	cfg_section_t *curr = &data->sections[index];
+
+	if (name)
+		curr->name = _cfg_string_copy(name);
+	else
+		curr->name = _cfg_string_append(NULL, "section%u", data->count);
+	curr->hash = cfg_hash(curr->name);
+	curr->count = 0;
+	curr->variables = NULL;
+	curr->tag_count = tag_count;
+	curr->tags = tags;
+
+	return curr;
+}
+
+cfg_section_t *cfg_section_get(cfg_data_t *data, char *name) {
+	return cfg_section_get_hash(data, cfg_hash(name));
+}
+
+cfg_section_t *cfg_section_get_hash(cfg_data_t *data, uint64_t hash) {
+	for (uint32_t i = 0; i < data->count; ++i) {
+		if (hash == data->sections[i].hash)
+			return &data->sections[i];
+	}
+	return NULL;
+}
+
+int64_t cfg_section_index(cfg_data_t *data, char *name) {
+	uint64_t hash = cfg_hash(name);
+	for (uint32_t i = 0; i < data->count; ++i) {
+		if (hash == data->sections[i].hash)
+			return i;
+	}
+	return -1;
+}
+
+uint32_t cfg_section_pointer_index(cfg_data_t *data, cfg_section_t *section) {
+	return data->sections - section;
+}
+
+void cfg_section_remove(cfg_data_t *data, uint32_t index) {
+	if (index > data->count - 1)
+		return;
+	--data->count;
+
+	cfg_section_t *curr = &data->sections[index];
+
+	if (curr->name)
+		free(curr->name);
+	if (curr->tags) {
+		for (uint32_t i = 0; i < curr->tag_count; ++i)
+			free(curr->tags[i]);
+		free(curr->tags);
+	}
+	if (curr->variables) {
+		// Remove from the back, so no variables have to be moved
+		while (curr->count)
+			cfg_variable_remove(curr, curr->count - 1);
+		free(curr->variables);
+	}
+
+	if (index < data->count)
+		memmove(curr, &data->sections[index + 1], sizeof(cfg_section_t) * (data->count - index));
+
+	data->sections = realloc(data->sections, sizeof(cfg_section_t) * data->count);
+}
+
+// Lists
+cfg_list_t *cfg_list_create() {
+	cfg_list_t *list = malloc(sizeof(cfg_list_t));
+	list->count = 0;
+	list->values = NULL;
+	return list;
+}
+
+void cfg_list_delete(cfg_list_t *list) {
+	if (list->values) {
+		for (uint32_t i = 0; i < list->count; ++i) {
+			if (list->values[i].type == CFG_STRING && list->values[i].value_string)
+				free(list->values[i].value_string);
+			else if (list->values[i].type == CFG_LIST && list->values[i].value_list)
+				cfg_list_delete(list->values[i].value_list);
+		}
+		free(list->values);
+	}
+	free(list);
+}
+
+cfg_value_t *cfg_list_add(cfg_list_t *list, cfg_value_t value, uint32_t index) {
+	if (index > list->count)
+		index = list->count;
+	++list->count;
+	
+	list->values = realloc(list->values, sizeof(cfg_value_t) * list->count);
+	if (index < list->count - 1)
+		memmove(&list->values[index + 1], &list->values[index], sizeof(cfg_value_t) * (list->count - index - 1));
+
+	cfg_value_t *curr = &list->values[index];
+	memcpy(curr, &value, sizeof(cfg_value_t));
+	if (value.type == CFG_STRING) {
+		if (value.value_string)
+			curr->value_string = _cfg_string_copy(value.value_string);
+		else
+			curr->value_string = "";
+	}
+
+	return curr;
+}
+
+void cfg_list_remove(cfg_list_t *list, uint32_t index) {
+	if (index > list->count - 1)
+		return;
+	--list->count;
+
+	cfg_value_t *curr = &list->values[index];
+
+	if (curr->type == CFG_STRING && curr->value_string)
+		free(curr->value_string);
+	else if (curr->type == CFG_LIST && curr->value_list)
+		cfg_list_delete(curr->value_list);
+
+	if (index < list->count)
+		memmove(curr, &list->values[index + 1], sizeof(cfg_value_t) * (list->count - index));
+
+	list->values = realloc(list->values, sizeof(cfg_value_t) * list->count);
+}
+
+// Variables
+cfg_variable_t *cfg_variable_add(cfg_section_t *section, char *name, cfg_value_t value, uint32_t index) {
+	if (index > section->count)
+		index = section->count;
+	++section->count;
+	
+	section->variables = realloc(section->variables, sizeof(cfg_variable_t) * section->count);
+	if (index < section->count - 1)
+		memmove(&section->variables[index + 1], &section->variables[index], sizeof(cfg_variable_t) * (section->count - index - 1));
+
+	cfg_variable_t *curr = &section->variables[index];
+
+	if (name)
+		curr->name = _cfg_string_copy(name);
+	else
+		curr->name = _cfg_string_append(NULL, "var%u", section->count);
+	curr->hash = cfg_hash(curr->name);
+
+	curr->value = value;
+	if (value.type == CFG_STRING) {
+		if (value.value_string)
+			curr->value.value_string = _cfg_string_copy(value.value_string);
+		else
+			curr->value.value_string = "";
+	}
+
+	return curr;
+}
+
+cfg_variable_t *cfg_variable_get(cfg_section_t *section, char *name) {
+	return cfg_variable_get_hash(section, cfg_hash(name));
+}
+
+cfg_variable_t *cfg_variable_get_hash(cfg_section_t *section, uint64_t hash) {
+	for (uint32_t i = 0; i < section->count; ++i) {
+		if (hash == section->variables[i].hash)
+			return &section->variables[i];
+	}
+	return NULL;
+}
+
+int64_t cfg_variable_index(cfg_section_t *section, char *name) {
+	uint64_t hash = cfg_hash(name);
+	for (uint32_t i = 0; i < section->count; ++i) {
+		if (hash == section->variables[i].hash)
+			return i;
+	}
+	return -1;
+}
+
+uint32_t cfg_variable_pointer_index(cfg_section_t *section, cfg_variable_t *variable) {
+	return section->variables - variable;
+}
+
+void cfg_variable_remove(cfg_section_t *section, uint32_t index) {
+	if (index > section->count - 1)
+		return;
+	--section->count;
+
+	cfg_variable_t *curr = &section->variables[index];
+
+	if (curr->name)
+		free(curr->name);
+
+	if (curr->value.type == CFG_STRING && curr->value.value_string)
+		free(curr->value.value_string);
+	else if (curr->value.type == CFG_LIST && curr->value.value_list)
+		cfg_list_delete(curr->value.value_list);
+
+	if (index < section->count)
+		memmove(curr, &section->variables[index + 1], sizeof(cfg_variable_t) * (section->count - index));
+
+	section->variables = realloc(section->variables, sizeof(cfg_variable_t) * section->count);
+}
+
+// Data
+char *cfg_data_write(cfg_data_t data) {
+	char *buffer = NULL;
+	for (uint32_t i = 0; i < data.include_count; ++i)
+		buffer = _cfg_string_append(buffer, "@include \"%s\"\n%s", data.includes[i], i == data.include_count - 1 ? "\n" : "");
+	for (uint32_t s = 0; s < data.count; ++s) {
+		cfg_section_t *section = &data.sections[s];
+		for (uint32_t t = 0; t < section->tag_count; ++t)
+			buffer = _cfg_string_append(buffer, "%s\n", section->tags[t]);
 		buffer = _cfg_string_append(buffer, "[%s]\n", section->name);
 		for (uint32_t c = 0; c < section->count; ++c) {
 			cfg_variable_t *variable = &section->variables[c];
@@ -569,6 +1611,7 @@ cfg_data_t cfg_data_read(char *source) {
 	_cfg_token_t *root_token = _cfg_tokenize(source);
 
 	// Tags
+	const uint64_t include_hash = cfg_hash("@include");
 	uint32_t tag_count = 0;
 	char **tags = NULL;
 
@@ -597,11 +1640,23 @@ cfg_data_t cfg_data_read(char *source) {
 			char *name = NULL;
 			if (prev_token && prev_token->type == _CFG_TOKEN_IDENTIFIER)
 				name = prev_token->string;
-			cfg_value_t value = _cfg_token_value(&token->next);
+			// Advance past the value tokens without unlinking them, so they are still freed below
+			_cfg_token_t *value_token = token->next;
+			cfg_value_t value = _cfg_token_value(&value_token);
 			cfg_variable_add(section, name, value, section->count);
+			if (value_token != token->next)
+				token = value_token;
 			break;
 		}
 		case _CFG_TOKEN_TAG:
+			// @include "path" is a directive, not a tag of the next section
+			if (token->next && token->next->type == _CFG_TOKEN_STRING && cfg_hash(token->string) == include_hash) {
+				token = token->next;
+				++data.include_count;
+				data.includes = realloc(data.includes, sizeof(char *) * data.include_count);
+				data.includes[data.include_count - 1] = _cfg_string_copy(token->string);
+				break;
+			}
 			++tag_count;
 			tags = realloc(tags, sizeof(char *) * tag_count);
 			tags[tag_count - 1] = _cfg_string_copy(token->string);
@@ -611,17 +1666,7 @@ cfg_data_t cfg_data_read(char *source) {
 		}
 	}
 
-	// Free the tokens
-	for (_cfg_token_t *token = root_token; token != NULL;) {
-		_cfg_token_t *t = token;
-		if (t) {
-			token = token->next;
-			if (t->string)
-				free(t->string);
-			free(t);
-		}
-	}
-
+	_cfg_tokens_free(root_token);
 	return data;
 }
 
@@ -639,30 +1684,852 @@ uint8_t cfg_data_write_file(char *path, cfg_data_t data) {
 cfg_data_t cfg_data_read_file(char *path) {
 	cfg_data_t data = { 0 };
 
-	FILE *f = fopen(path, "rb");
-	if (!f)
+	char *source = _cfg_file_read(path);
+	if (!source)
 		return data;
-
-	fseek(f, 0, SEEK_END);
-	uint64_t fsize = ftell(f);
-	fseek(f, 0, SEEK_SET);
-
-	char *source = malloc(fsize + 1);
-	fread(source, fsize, 1, f);
-	fclose(f);
-	
-	source[fsize] = 0;
 	data = cfg_data_read(source);
 
 	free(source);
 	return data;
 }
 
+// Binding
+uint32_t cfg_bind(char *source, char *section, cfg_schema_t *schema, void *out, uint32_t capacity) {
+	uint64_t filter = section ? cfg_hash(section) : 0;
+	uint64_t *hashes = malloc(sizeof(uint64_t) * (schema->count + 1));
+	for (uint32_t f = 0; f < schema->count; ++f)
+		hashes[f] = cfg_hash(schema->fields[f].name);
+
+	_cfg_token_t *root_token = _cfg_tokenize(source);
+	uint32_t sections = 0, bound = 0;
+	uint8_t *object = NULL;
+
+	// Walks the tokens like cfg_data_read, but stores the values straight into the structs
+	for (_cfg_token_t *prev_token = NULL, *token = root_token; token != NULL; prev_token = token, token = token->next) {
+		switch (token->type) {
+		case _CFG_TOKEN_SECTION_END:
+			if (prev_token && prev_token->type == _CFG_TOKEN_SECTION_BEGIN)
+				object = _cfg_bind_section(schema, out, capacity, &bound, filter, NULL, ++sections);
+			break;
+		case _CFG_TOKEN_SECTION:
+			object = _cfg_bind_section(schema, out, capacity, &bound, filter, token->string, ++sections);
+			break;
+		case _CFG_TOKEN_ASSIGN: {
+			if (!sections)
+				object = _cfg_bind_section(schema, out, capacity, &bound, filter, NULL, ++sections);
+
+			_cfg_token_t *value_token = token->next;
+			uint32_t f = schema->count;
+			if (object && prev_token && prev_token->type == _CFG_TOKEN_IDENTIFIER) {
+				uint64_t hash = cfg_hash(prev_token->string);
+				for (f = 0; f < schema->count && hashes[f] != hash; ++f);
+			}
+
+			if (f < schema->count) {
+				// Lists are built for the member, so they are only freed if it does not take them
+				cfg_value_t value = _cfg_token_value(&value_token);
+				if (!_cfg_bind_store(&schema->fields[f], object, value, 1) && value.type == CFG_LIST)
+					cfg_list_delete(value.value_list);
+			} else {
+				_cfg_token_skip(&value_token);
+			}
+			if (value_token != token->next)
+				token = value_token;
+			break;
+		}
+		default:
+			break;
+		}
+
+		// Nothing is left to bind once every struct is filled and the last one is done
+		if (!object && bound >= capacity)
+			break;
+	}
+
+	_cfg_tokens_free(root_token);
+	free(hashes);
+	return bound;
+}
+
+uint32_t cfg_bind_file(char *path, char *section, cfg_schema_t *schema, void *out, uint32_t capacity) {
+	char *source = _cfg_file_read(path);
+	if (!source)
+		return 0;
+	uint32_t bound = cfg_bind(source, section, schema, out, capacity);
+	free(source);
+	return bound;
+}
+
+void cfg_bind_free(cfg_schema_t *schema, void *out, uint32_t count) {
+	for (uint32_t i = 0; i < count; ++i) {
+		uint8_t *object = (uint8_t *)out + (uint64_t)schema->size * i;
+		for (uint32_t f = 0; f < schema->count; ++f) {
+			cfg_field_t *field = &schema->fields[f];
+			void **member = (void **)(object + field->offset);
+			if (field->type == CFG_STRING)
+				free(*member);
+			else if (field->type == CFG_LIST && *member)
+				cfg_list_delete(*member);
+			if (field->type == CFG_STRING || field->type == CFG_LIST)
+				*member = NULL;
+		}
+	}
+}
+
+uint32_t cfg_data_read_files(char **paths, uint32_t count, cfg_file_result_t *out) {
+	_cfg_batch_t batch = { .paths = paths, .count = count, .out = out };
+
+#ifdef CFG_THREADS
+	atomic_init(&batch.next, 0);
+	int64_t threads = CFG_THREADS > 0 ? CFG_THREADS : sysconf(_SC_NPROCESSORS_ONLN);
+	if (threads > count)
+		threads = count;
+
+	// The calling thread is one of the workers
+	uint32_t started = 0;
+	pthread_t *workers = threads > 1 ? malloc(sizeof(pthread_t) * (threads - 1)) : NULL;
+	while (started + 1 < threads && !pthread_create(&workers[started], NULL, _cfg_batch_worker, &batch))
+		++started;
+#endif
+
+	_cfg_batch_worker(&batch);
+
+#ifdef CFG_THREADS
+	for (uint32_t i = 0; i < started; ++i)
+		pthread_join(workers[i], NULL);
+	free(workers);
+#endif
+
+	uint32_t read = 0;
+	for (uint32_t i = 0; i < count; ++i) {
+		if (!out[i].error)
+			++read;
+	}
+	return read;
+}
+
 void cfg_data_free(cfg_data_t *data) {
-	if (data->sections) {
-		for (uint32_t i = 0; i < data->count; ++i)
-			cfg_section_remove(data, i);
+	// Remove from the back, so no sections have to be moved
+	while (data->count)
+		cfg_section_remove(data, data->count - 1);
+	free(data->sections);
+	data->sections = NULL;
+
+	for (uint32_t i = 0; i < data->include_count; ++i)
+		free(data->includes[i]);
+	free(data->includes);
+	data->include_count = 0;
+	data->includes = NULL;
+}
+
+// Patches
+// Order is not compared: sections and variables that only moved give no entries
+cfg_patch_t cfg_data_diff(cfg_data_t *from, cfg_data_t *to) {
+	cfg_patch_t patch = { 0 };
+	cfg_value_t none = { 0 };
+	_cfg_occurrences_t from_buffers = { 0 }, to_buffers = { 0 }, x_buffers = { 0 }, y_buffers = { 0 };
+	uint32_t *from_occurrences = _cfg_occurrences_count(&from_buffers, from->count ? &from->sections[0].hash : NULL,
+	                                                    from->count, sizeof(cfg_section_t));
+	uint32_t *to_occurrences = _cfg_occurrences_count(&to_buffers, to->count ? &to->sections[0].hash : NULL,
+	                                                  to->count, sizeof(cfg_section_t));
+
+	// Removed sections come first, so the insertion indices below refer to the patched document. They are removed
+	// from the back, so the occurrences of the remaining ones stay valid
+	for (uint32_t s = from->count; s > 0; --s) {
+		cfg_section_t *a = &from->sections[s - 1];
+		if (!_cfg_section_find(to, to_occurrences, a->hash, from_occurrences[s - 1], s - 1))
+			_cfg_patch_push(&patch, CFG_PATCH_SECTION_REMOVE, a->name, from_occurrences[s - 1], NULL, 0, 0, 0, NULL, none);
+	}
+
+	for (uint32_t s = 0; s < to->count; ++s) {
+		cfg_section_t *b = &to->sections[s];
+		uint32_t occurrence = to_occurrences[s];
+		cfg_section_t *a = _cfg_section_find(from, from_occurrences, b->hash, occurrence, s);
+		uint32_t *y_occurrences = _cfg_occurrences_count(&y_buffers, b->count ? &b->variables[0].hash : NULL,
+		                                                 b->count, sizeof(cfg_variable_t));
+
+		if (!a) {
+			_cfg_patch_push_section(&patch, CFG_PATCH_SECTION_ADD, b, occurrence, s);
+			for (uint32_t v = 0; v < b->count; ++v)
+				_cfg_patch_push(&patch, CFG_PATCH_VARIABLE_ADD, b->name, occurrence, b->variables[v].name, y_occurrences[v],
+				                v, 0, NULL, b->variables[v].value);
+			continue;
+		}
+
+		if (!_cfg_tags_equal(a, b))
+			_cfg_patch_push_section(&patch, CFG_PATCH_SECTION_TAGS, b, occurrence, s);
+
+		uint32_t *x_occurrences = _cfg_occurrences_count(&x_buffers, a->count ? &a->variables[0].hash : NULL,
+		                                                 a->count, sizeof(cfg_variable_t));
+		for (uint32_t v = a->count; v > 0; --v) {
+			cfg_variable_t *x = &a->variables[v - 1];
+			if (!_cfg_variable_find(b, y_occurrences, x->hash, x_occurrences[v - 1], v - 1))
+				_cfg_patch_push(&patch, CFG_PATCH_VARIABLE_REMOVE, b->name, occurrence, x->name, x_occurrences[v - 1],
+				                0, 0, NULL, none);
+		}
+
+		for (uint32_t v = 0; v < b->count; ++v) {
+			cfg_variable_t *y = &b->variables[v];
+			cfg_variable_t *x = _cfg_variable_find(a, x_occurrences, y->hash, y_occurrences[v], v);
+			if (!x)
+				_cfg_patch_push(&patch, CFG_PATCH_VARIABLE_ADD, b->name, occurrence, y->name, y_occurrences[v], v, 0, NULL, y->value);
+			else if (_cfg_value_equal(x->value, y->value))
+				continue;
+			else if (x->value.type == CFG_LIST && y->value.type == CFG_LIST) {
+				cfg_patch_entry_t target = { .section = b->name, .variable = y->name,
+				                             .section_occurrence = occurrence, .variable_occurrence = y_occurrences[v] };
+				_cfg_patch_diff_list(&patch, &target, 0, NULL, x->value.value_list, y->value.value_list);
+			} else
+				_cfg_patch_push(&patch, CFG_PATCH_VARIABLE_CHANGE, b->name, occurrence, y->name, y_occurrences[v], 0, 0, NULL, y->value);
+		}
+	}
+
+	_cfg_occurrences_free(&from_buffers);
+	_cfg_occurrences_free(&to_buffers);
+	_cfg_occurrences_free(&x_buffers);
+	_cfg_occurrences_free(&y_buffers);
+	return patch;
+}
+
+uint8_t cfg_data_patch(cfg_data_t *data, cfg_patch_t patch) {
+	uint8_t result = 1;
+
+	for (uint32_t e = 0; e < patch.count; ++e) {
+		cfg_patch_entry_t *entry = &patch.entries[e];
+		uint64_t section_hash = cfg_hash(entry->section);
+		cfg_section_t *section = _cfg_section_nth(data, section_hash, entry->section_occurrence);
+
+		if (entry->op == CFG_PATCH_SECTION_ADD || entry->op == CFG_PATCH_SECTION_TAGS) {
+			// Added sections must not exist yet, retagged ones must. Earlier sections with the same name may exist
+			if ((entry->op == CFG_PATCH_SECTION_ADD) == (section != NULL) ||
+			    entry->value.type != CFG_LIST) {
+				result = 0;
+				continue;
+			}
+			// An added section goes after the previous one with its name, or it would take that one's occurrence
+			uint32_t index = entry->index;
+			if (entry->op == CFG_PATCH_SECTION_ADD && entry->section_occurrence) {
+				cfg_section_t *previous = _cfg_section_nth(data, section_hash, entry->section_occurrence - 1);
+				if (!previous) {
+					result = 0;
+					continue;
+				}
+				if (index <= previous - data->sections)
+					index = previous - data->sections + 1;
+			}
+			cfg_list_t *list = entry->value.value_list;
+			char **tags = list->count ? malloc(sizeof(char *) * list->count) : NULL;
+			for (uint32_t t = 0; t < list->count; ++t)
+				tags[t] = _cfg_string_copy(list->values[t].type == CFG_STRING ? list->values[t].value_string : "");
+
+			if (entry->op == CFG_PATCH_SECTION_ADD) {
+				cfg_section_add(data, entry->section, index, list->count, tags);
+			} else {
+				for (uint32_t t = 0; t < section->tag_count; ++t)
+					free(section->tags[t]);
+				free(section->tags);
+				section->tag_count = list->count;
+				section->tags = tags;
+			}
+			continue;
+		}
+
+		if (!section) {
+			result = 0;
+			continue;
+		}
+		if (entry->op == CFG_PATCH_SECTION_REMOVE) {
+			cfg_section_remove(data, section - data->sections);
+			continue;
+		}
+
+		uint64_t variable_hash = entry->variable ? cfg_hash(entry->variable) : 0;
+		cfg_variable_t *variable = entry->variable ? _cfg_variable_nth(section, variable_hash, entry->variable_occurrence) : NULL;
+		if (entry->op == CFG_PATCH_VARIABLE_ADD) {
+			if (variable || !entry->variable) {
+				result = 0;
+				continue;
+			}
+			// Same as for sections: keep added variables behind earlier ones with the same name
+			uint32_t index = entry->index;
+			if (entry->variable_occurrence) {
+				cfg_variable_t *previous = _cfg_variable_nth(section, variable_hash, entry->variable_occurrence - 1);
+				if (!previous) {
+					result = 0;
+					continue;
+				}
+				if (index <= previous - section->variables)
+					index = previous - section->variables + 1;
+			}
+			variable = cfg_variable_add(section, entry->variable, (cfg_value_t) { 0 }, index);
+			variable->value = _cfg_value_clone(entry->value);
+			continue;
+		}
+		if (!variable) {
+			result = 0;
+			continue;
+		}
+
+		switch (entry->op) {
+		case CFG_PATCH_VARIABLE_REMOVE:
+			cfg_variable_remove(section, variable - section->variables);
+			break;
+		case CFG_PATCH_VARIABLE_CHANGE:
+			_cfg_value_free(&variable->value);
+			variable->value = _cfg_value_clone(entry->value);
+			break;
+		case CFG_PATCH_LIST_ADD:
+		case CFG_PATCH_LIST_REMOVE:
+		case CFG_PATCH_LIST_CHANGE: {
+			// Walk down to the list that holds the element
+			cfg_value_t *value = &variable->value;
+			for (uint32_t d = 0; value && d + 1 < entry->depth; ++d) {
+				if (value->type != CFG_LIST || entry->path[d] >= value->value_list->count)
+					value = NULL;
+				else
+					value = &value->value_list->values[entry->path[d]];
+			}
+			if (!entry->depth || !value || value->type != CFG_LIST) {
+				result = 0;
+				break;
+			}
+
+			cfg_list_t *list = value->value_list;
+			uint32_t index = entry->path[entry->depth - 1];
+			if (entry->op == CFG_PATCH_LIST_ADD) {
+				if (index > list->count) {
+					result = 0;
+					break;
+				}
+				*cfg_list_add(list, (cfg_value_t) { 0 }, index) = _cfg_value_clone(entry->value);
+			} else if (index >= list->count) {
+				result = 0;
+			} else if (entry->op == CFG_PATCH_LIST_REMOVE) {
+				cfg_list_remove(list, index);
+			} else {
+				_cfg_value_free(&list->values[index]);
+				list->values[index] = _cfg_value_clone(entry->value);
+			}
+			break;
+		}
+		default:
+			result = 0;
+			break;
+		}
+	}
+
+	return result;
+}
+
+// A text patch is itself a cfg document: one section per entry, tagged with the operation
+char *cfg_patch_write(cfg_patch_t patch) {
+	char *buffer = NULL;
+	for (uint32_t e = 0; e < patch.count; ++e) {
+		cfg_patch_entry_t *entry = &patch.entries[e];
+		buffer = _cfg_string_append(buffer, "%s\n[%s]\n", _cfg_patch_op_names[entry->op], entry->section);
+
+		if (entry->variable)
+			buffer = _cfg_string_append(buffer, "variable = \"%s\"\n", entry->variable);
+		if (entry->section_occurrence)
+			buffer = _cfg_string_append(buffer, "section_occurrence = %u\n", entry->section_occurrence);
+		if (entry->variable_occurrence)
+			buffer = _cfg_string_append(buffer, "variable_occurrence = %u\n", entry->variable_occurrence);
+		if (entry->op == CFG_PATCH_SECTION_ADD || entry->op == CFG_PATCH_VARIABLE_ADD)
+			buffer = _cfg_string_append(buffer, "index = %u\n", entry->index);
+		if (entry->depth) {
+			buffer = _cfg_string_append(buffer, "path = (");
+			for (uint32_t d = 0; d < entry->depth; ++d)
+				buffer = _cfg_string_append(buffer, d ? " %u" : "%u", entry->path[d]);
+			buffer = _cfg_string_append(buffer, ")\n");
+		}
+
+		switch (entry->op) {
+		case CFG_PATCH_SECTION_ADD:
+		case CFG_PATCH_SECTION_TAGS:
+			buffer = _cfg_string_append(buffer, "tags = ");
+			buffer = _cfg_value_write(buffer, entry->value);
+			buffer = _cfg_string_append(buffer, "\n");
+			break;
+		case CFG_PATCH_VARIABLE_ADD:
+		case CFG_PATCH_VARIABLE_CHANGE:
+		case CFG_PATCH_LIST_ADD:
+		case CFG_PATCH_LIST_CHANGE:
+			buffer = _cfg_string_append(buffer, "value = ");
+			buffer = _cfg_value_write(buffer, entry->value);
+			buffer = _cfg_string_append(buffer, "\n");
+			break;
+		default:
+			break;
+		}
+		buffer = _cfg_string_append(buffer, "\n");
+	}
+	return buffer;
+}
+
+cfg_patch_t cfg_patch_read(char *source) {
+	cfg_patch_t patch = { 0 };
+	cfg_data_t data = cfg_data_read(source);
+	const uint32_t op_count = sizeof(_cfg_patch_op_names) / sizeof(_cfg_patch_op_names[0]);
+
+	for (uint32_t s = 0; s < data.count; ++s) {
+		cfg_section_t *section = &data.sections[s];
+		if (!section->tag_count)
+			continue;
+
+		uint32_t op = 0;
+		uint64_t hash = cfg_hash(section->tags[0]);
+		while (op < op_count && cfg_hash(_cfg_patch_op_names[op]) != hash)
+			++op;
+		if (op == op_count)
+			continue;
+
+		cfg_value_t none = { 0 };
+		cfg_variable_t *variable = cfg_variable_get(section, "variable");
+		cfg_variable_t *section_occurrence = cfg_variable_get(section, "section_occurrence");
+		cfg_variable_t *variable_occurrence = cfg_variable_get(section, "variable_occurrence");
+		cfg_variable_t *index = cfg_variable_get(section, "index");
+		cfg_variable_t *path = cfg_variable_get(section, "path");
+		cfg_variable_t *value = cfg_variable_get(section, op <= CFG_PATCH_SECTION_TAGS ? "tags" : "value");
+
+		uint32_t depth = 0, *indices = NULL;
+		if (path && path->value.type == CFG_LIST) {
+			depth = path->value.value_list->count;
+			indices = malloc(sizeof(uint32_t) * (depth + 1));
+			for (uint32_t d = 0; d < depth; ++d)
+				indices[d] = path->value.value_list->values[d].value_int;
+		}
+
+		_cfg_patch_push(&patch, op, section->name,
+		                section_occurrence && section_occurrence->value.type == CFG_INT ? section_occurrence->value.value_int : 0,
+		                variable && variable->value.type == CFG_STRING ? variable->value.value_string : NULL,
+		                variable_occurrence && variable_occurrence->value.type == CFG_INT ? variable_occurrence->value.value_int : 0,
+		                index && index->value.type == CFG_INT ? index->value.value_int : 0,
+		                depth, indices, value ? value->value : none);
+		free(indices);
+	}
+
+	cfg_data_free(&data);
+	return patch;
+}
+
+uint8_t *cfg_patch_write_binary(cfg_patch_t patch, uint64_t *size) {
+	_cfg_buffer_t buffer = { 0 };
+	_cfg_buffer_write(&buffer, "CFGP", 4);
+	_cfg_buffer_write(&buffer, &patch.count, sizeof(uint32_t));
+
+	for (uint32_t e = 0; e < patch.count; ++e) {
+		cfg_patch_entry_t *entry = &patch.entries[e];
+		uint8_t op = entry->op;
+		_cfg_buffer_write(&buffer, &op, 1);
+		_cfg_buffer_write_string(&buffer, entry->section);
+		_cfg_buffer_write_string(&buffer, entry->variable);
+		_cfg_buffer_write(&buffer, &entry->section_occurrence, sizeof(uint32_t));
+		_cfg_buffer_write(&buffer, &entry->variable_occurrence, sizeof(uint32_t));
+		_cfg_buffer_write(&buffer, &entry->index, sizeof(uint32_t));
+		_cfg_buffer_write(&buffer, &entry->depth, sizeof(uint32_t));
+		if (entry->depth)
+			_cfg_buffer_write(&buffer, entry->path, sizeof(uint32_t) * entry->depth);
+		_cfg_buffer_write_value(&buffer, entry->value);
+	}
+
+	*size = buffer.size;
+	return buffer.data;
+}
+
+cfg_patch_t cfg_patch_read_binary(uint8_t *data, uint64_t size) {
+	cfg_patch_t patch = { 0 };
+	// Reading uses size as the cursor and capacity as the end of the buffer
+	_cfg_buffer_t buffer = { data, 0, size };
+
+	char magic[4];
+	uint32_t count;
+	if (!_cfg_buffer_read(&buffer, magic, 4) || memcmp(magic, "CFGP", 4) ||
+	    !_cfg_buffer_read(&buffer, &count, sizeof(uint32_t)))
+		return patch;
+
+	for (uint32_t e = 0; e < count; ++e) {
+		uint8_t op;
+		if (!_cfg_buffer_read(&buffer, &op, 1) || op > CFG_PATCH_LIST_CHANGE)
+			goto error;
+
+		++patch.count;
+		patch.entries = realloc(patch.entries, sizeof(cfg_patch_entry_t) * patch.count);
+		cfg_patch_entry_t *curr = &patch.entries[patch.count - 1];
+		memset(curr, 0, sizeof(cfg_patch_entry_t));
+		curr->op = op;
+
+		if (!_cfg_buffer_read_string(&buffer, &curr->section) || !curr->section ||
+		    !_cfg_buffer_read_string(&buffer, &curr->variable) ||
+		    !_cfg_buffer_read(&buffer, &curr->section_occurrence, sizeof(uint32_t)) ||
+		    !_cfg_buffer_read(&buffer, &curr->variable_occurrence, sizeof(uint32_t)) ||
+		    !_cfg_buffer_read(&buffer, &curr->index, sizeof(uint32_t)) ||
+		    !_cfg_buffer_read(&buffer, &curr->depth, sizeof(uint32_t)) ||
+		    curr->depth > (buffer.capacity - buffer.size) / sizeof(uint32_t))
+			goto error;
+		if (curr->depth) {
+			curr->path = malloc(sizeof(uint32_t) * curr->depth);
+			_cfg_buffer_read(&buffer, curr->path, sizeof(uint32_t) * curr->depth);
+		}
+		if (!_cfg_buffer_read_value(&buffer, &curr->value))
+			goto error;
+	}
+	return patch;
+
+error:
+	cfg_patch_free(&patch);
+	return patch;
+}
+
+void cfg_patch_free(cfg_patch_t *patch) {
+	for (uint32_t e = 0; e < patch->count; ++e) {
+		cfg_patch_entry_t *entry = &patch->entries[e];
+		free(entry->section);
+		free(entry->variable);
+		free(entry->path);
+		_cfg_value_free(&entry->value);
+	}
+	free(patch->entries);
+	patch->count = 0;
+	patch->entries = NULL;
+}
+
+// Overlays
+uint8_t cfg_overlay_add(cfg_overlay_t *overlay, cfg_data_t data) {
+	uint8_t result = 1;
+	_cfg_overlay_insert(overlay, overlay->count, NULL, data, &result);
+	cfg_overlay_invalidate(overlay);
+	return result;
+}
+
+uint8_t cfg_overlay_add_file(cfg_overlay_t *overlay, char *path) {
+	uint8_t result = 1;
+	char *resolved = _cfg_path_resolve(NULL, path);
+	if (_cfg_overlay_find(overlay, resolved) >= 0) {
+		free(resolved);
+		return result;
+	}
+
+	char *source = _cfg_file_read(resolved);
+	if (!source) {
+		free(resolved);
+		return 0;
+	}
+	cfg_data_t data = cfg_data_read(source);
+	free(source);
+
+	_cfg_overlay_insert(overlay, overlay->count, resolved, data, &result);
+	cfg_overlay_invalidate(overlay);
+	return result;
+}
+
+int64_t cfg_overlay_index(cfg_overlay_t *overlay, char *path) {
+	char *resolved = _cfg_path_resolve(NULL, path);
+	int64_t index = _cfg_overlay_find(overlay, resolved);
+	free(resolved);
+	return index;
+}
+
+uint8_t cfg_overlay_reload(cfg_overlay_t *overlay, uint32_t index) {
+	if (index >= overlay->count || !overlay->layers[index].path)
+		return 0;
+
+	char *source = _cfg_file_read(overlay->layers[index].path);
+	if (!source)
+		return 0;
+	cfg_data_free(&overlay->layers[index].data);
+	overlay->layers[index].data = cfg_data_read(source);
+	free(source);
+
+	// Files that are newly included are layered directly below the reloaded one
+	uint8_t result = 1;
+	_cfg_overlay_include(overlay, index, &result);
+	cfg_overlay_invalidate(overlay);
+	return result;
+}
+
+void cfg_overlay_invalidate(cfg_overlay_t *overlay) {
+	// A table that grew past its first size is dropped, it would otherwise stay as large as the most keys (and
+	// misses) any generation ever looked up. It grows again with the lookups against the new layers
+	overlay->cache_count = 0;
+	if (overlay->cache_capacity > 64) {
+		free(overlay->cache);
+		overlay->cache = NULL;
+		overlay->cache_capacity = 0;
+	}
+	// Entries of older generations count as empty, so this clears a small cache without touching it
+	if (!++overlay->generation) {
+		memset(overlay->cache, 0, sizeof(cfg_overlay_entry_t) * overlay->cache_capacity);
+		overlay->generation = 1;
+	}
+}
+
+cfg_variable_t *cfg_overlay_get(cfg_overlay_t *overlay, char *section, char *name) {
+	return cfg_overlay_get_hash(overlay, cfg_hash(section), cfg_hash(name));
+}
+
+cfg_variable_t *cfg_overlay_get_hash(cfg_overlay_t *overlay, uint64_t section, uint64_t name) {
+	if (!overlay->generation)
+		overlay->generation = 1;
+
+	if (overlay->cache_capacity) {
+		uint32_t mask = overlay->cache_capacity - 1;
+		for (uint32_t slot = _cfg_overlay_slot(section, name) & mask;; slot = (slot + 1) & mask) {
+			cfg_overlay_entry_t *entry = &overlay->cache[slot];
+			if (entry->generation != overlay->generation)
+				break;
+			if (entry->section == section && entry->variable == name)
+				return entry->value;
+		}
+	}
+
+	// Resolve through the layers, highest priority first
+	cfg_variable_t *value = NULL;
+	for (uint32_t l = overlay->count; l-- > 0 && !value;) {
+		cfg_section_t *s = cfg_section_get_hash(&overlay->layers[l].data, section);
+		if (s)
+			value = cfg_variable_get_hash(s, name);
+	}
+
+	_cfg_overlay_cache(overlay, section, name, value);
+	return value;
+}
+
+cfg_data_t cfg_overlay_merge(cfg_overlay_t *overlay) {
+	cfg_data_t data = { 0 };
+
+	for (uint32_t l = 0; l < overlay->count; ++l) {
+		cfg_data_t *layer = &overlay->layers[l].data;
+		for (uint32_t s = 0; s < layer->count; ++s) {
+			cfg_section_t *from = &layer->sections[s];
+			cfg_section_t *to = cfg_section_get_hash(&data, from->hash);
+
+			if (!to) {
+				to = cfg_section_add(&data, from->name, data.count, from->tag_count, _cfg_tags_copy(from->tag_count, from->tags));
+			} else if (from->tag_count) {
+				// Tags are not merged, the highest layer that tags the section wins
+				for (uint32_t t = 0; t < to->tag_count; ++t)
+					free(to->tags[t]);
+				free(to->tags);
+				to->tag_count = from->tag_count;
+				to->tags = _cfg_tags_copy(from->tag_count, from->tags);
+			}
+
+			for (uint32_t v = 0; v < from->count; ++v) {
+				cfg_variable_t *variable = cfg_variable_get_hash(to, from->variables[v].hash);
+				if (variable)
+					_cfg_value_free(&variable->value);
+				else
+					variable = cfg_variable_add(to, from->variables[v].name, (cfg_value_t) { 0 }, to->count);
+				variable->value = _cfg_value_clone(from->variables[v].value);
+			}
+		}
+	}
+
+	return data;
+}
+
+void cfg_overlay_free(cfg_overlay_t *overlay) {
+	for (uint32_t l = 0; l < overlay->count; ++l) {
+		free(overlay->layers[l].path);
+		cfg_data_free(&overlay->layers[l].data);
+	}
+	free(overlay->layers);
+	free(overlay->cache);
+	memset(overlay, 0, sizeof(cfg_overlay_t));
+}
+
+// Frozen documents
+cfg_frozen_t cfg_data_freeze(cfg_data_t *data) {
+	cfg_frozen_t frozen = { 0 };
+	frozen.count = data->count;
+	frozen.include_count = data->include_count;
+
+	// Count first, so the records fit in one block. The empty string is always in the pool
+	uint32_t strings = 1 + data->count + data->include_count;
+	for (uint32_t s = 0; s < data->count; ++s) {
+		cfg_section_t *section = &data->sections[s];
+		frozen.variable_count += section->count;
+		frozen.tag_count += section->tag_count;
+		strings += section->count + section->tag_count;
+		for (uint32_t v = 0; v < section->count; ++v)
+			_cfg_freeze_count(&frozen, section->variables[v].value, &strings);
+	}
+
+	_cfg_freezer_t freezer = { .frozen = &frozen };
+	uint32_t slots = 16;
+	while (slots < strings * 2)
+		slots *= 2;
+	freezer.table = calloc(slots, sizeof(uint32_t));
+	freezer.mask = slots - 1;
+	_cfg_freeze_string(&freezer, "");
+
+	// The pool is appended once it is complete
+	uint64_t size = _cfg_frozen_size(&frozen);
+	uint8_t *block = malloc(size + freezer.pool_size);
+	_cfg_frozen_layout(&frozen, block);
+
+	uint32_t tag = 0;
+	for (uint32_t s = 0; s < data->count; ++s) {
+		cfg_section_t *section = &data->sections[s];
+		cfg_frozen_section_t *frozen_section = &frozen.sections[s];
+		frozen_section->hash = section->hash;
+		frozen_section->name = _cfg_freeze_string(&freezer, section->name);
+		frozen_section->variables = freezer.variable;
+		frozen_section->count = section->count;
+		frozen_section->tags = tag;
+		frozen_section->tag_count = section->tag_count;
+		for (uint32_t t = 0; t < section->tag_count; ++t)
+			frozen.tags[tag++] = _cfg_freeze_string(&freezer, section->tags[t]);
+
+		for (uint32_t v = 0; v < section->count; ++v) {
+			cfg_frozen_variable_t *frozen_variable = &frozen.variables[freezer.variable++];
+			frozen_variable->hash = section->variables[v].hash;
+			frozen_variable->name = _cfg_freeze_string(&freezer, section->variables[v].name);
+			frozen_variable->value = _cfg_freeze_value(&freezer, section->variables[v].value);
+		}
+	}
+	for (uint32_t i = 0; i < data->include_count; ++i)
+		frozen.includes[i] = _cfg_freeze_string(&freezer, data->includes[i]);
+
+	frozen.string_size = freezer.pool_size;
+	block = realloc(block, size + freezer.pool_size);
+	_cfg_frozen_layout(&frozen, block);
+	memcpy(frozen.strings, freezer.pool, freezer.pool_size);
+
+	free(freezer.pool);
+	free(freezer.table);
+	return frozen;
+}
+
+cfg_data_t cfg_frozen_thaw(cfg_frozen_t *frozen) {
+	cfg_data_t data = { 0 };
+	for (uint32_t s = 0; s < frozen->count; ++s) {
+		cfg_frozen_section_t *frozen_section = &frozen->sections[s];
+		char **tags = frozen_section->tag_count ? malloc(sizeof(char *) * frozen_section->tag_count) : NULL;
+		for (uint32_t t = 0; t < frozen_section->tag_count; ++t)
+			tags[t] = _cfg_string_copy(frozen->strings + frozen->tags[frozen_section->tags + t]);
+
+		cfg_section_t *section = cfg_section_add(&data, frozen->strings + frozen_section->name, s, frozen_section->tag_count, tags);
+		for (uint32_t v = 0; v < frozen_section->count; ++v) {
+			cfg_frozen_variable_t *frozen_variable = &frozen->variables[frozen_section->variables + v];
+			cfg_variable_add(section, frozen->strings + frozen_variable->name, _cfg_thaw_value(frozen, frozen_variable->value), v);
+		}
+	}
+
+	data.include_count = frozen->include_count;
+	data.includes = frozen->include_count ? malloc(sizeof(char *) * frozen->include_count) : NULL;
+	for (uint32_t i = 0; i < frozen->include_count; ++i)
+		data.includes[i] = _cfg_string_copy(frozen->strings + frozen->includes[i]);
+	return data;
+}
+
+cfg_frozen_section_t *cfg_frozen_section_get(cfg_frozen_t *frozen, char *name) {
+	return cfg_frozen_section_get_hash(frozen, cfg_hash(name));
+}
+
+cfg_frozen_section_t *cfg_frozen_section_get_hash(cfg_frozen_t *frozen, uint64_t hash) {
+	for (uint32_t i = 0; i < frozen->count; ++i) {
+		if (hash == frozen->sections[i].hash)
+			return &frozen->sections[i];
+	}
+	return NULL;
+}
+
+cfg_frozen_variable_t *cfg_frozen_variable_get(cfg_frozen_t *frozen, cfg_frozen_section_t *section, char *name) {
+	return cfg_frozen_variable_get_hash(frozen, section, cfg_hash(name));
+}
+
+cfg_frozen_variable_t *cfg_frozen_variable_get_hash(cfg_frozen_t *frozen, cfg_frozen_section_t *section, uint64_t hash) {
+	cfg_frozen_variable_t *variables = &frozen->variables[section->variables];
+	for (uint32_t i = 0; i < section->count; ++i) {
+		if (hash == variables[i].hash)
+			return &variables[i];
+	}
+	return NULL;
+}
+
+// Names, tags and include paths are offsets too, for example cfg_frozen_string(frozen, section->name)
+char *cfg_frozen_string(cfg_frozen_t *frozen, uint32_t offset) {
+	return frozen->strings + offset;
+}
+
+// Strings point into the pool and must not be freed. Lists have no cfg_list_t, so value_list is NULL
+cfg_value_t cfg_frozen_value_get(cfg_frozen_t *frozen, cfg_frozen_value_t value) {
+	cfg_value_t thawed = { value.type, { 0 } };
+	switch (value.type) {
+	case CFG_INT:
+		thawed.value_int = value.value_int;
+		break;
+	case CFG_FLOAT:
+		thawed.value_float = frozen->floats[value.value_float];
+		break;
+	case CFG_STRING:
+		thawed.value_string = frozen->strings + value.value_string;
+		break;
+	case CFG_BOOL:
+		thawed.value_bool = value.value_bool;
+		break;
+	case CFG_LIST:
+		break;
+	}
+	return thawed;
+}
+
+// The elements are frozen->values[list->first] to frozen->values[list->first + list->count - 1]
+cfg_frozen_list_t *cfg_frozen_list_get(cfg_frozen_t *frozen, cfg_frozen_value_t value) {
+	if (value.type != CFG_LIST)
+		return NULL;
+	return &frozen->lists[value.value_list];
+}
+
+void cfg_frozen_free(cfg_frozen_t *frozen) {
+	free(frozen->sections);
+	memset(frozen, 0, sizeof(cfg_frozen_t));
+}
+
+// Memory usage
+cfg_memory_usage_t cfg_data_memory_usage(cfg_data_t *data) {
+	cfg_memory_usage_t usage = { 0 };
+	usage.sections = sizeof(cfg_section_t) * data->count;
+	usage.allocations += data->count ? 1 : 0;
+
+	for (uint32_t s = 0; s < data->count; ++s) {
+		cfg_section_t *section = &data->sections[s];
+		_cfg_memory_string(&usage, section->name);
+		usage.tags += sizeof(char *) * section->tag_count;
+		usage.allocations += section->tags ? 1 : 0;
+		for (uint32_t t = 0; t < section->tag_count; ++t)
+			_cfg_memory_string(&usage, section->tags[t]);
+
+		usage.variables += sizeof(cfg_variable_t) * section->count;
+		usage.allocations += section->variables ? 1 : 0;
+		for (uint32_t v = 0; v < section->count; ++v) {
+			_cfg_memory_string(&usage, section->variables[v].name);
+			_cfg_memory_value(&usage, section->variables[v].value);
+		}
 	}
+
+	usage.includes = sizeof(char *) * data->include_count;
+	usage.allocations += data->includes ? 1 : 0;
+	for (uint32_t i = 0; i < data->include_count; ++i)
+		_cfg_memory_string(&usage, data->includes[i]);
+
+	usage.total = usage.sections + usage.variables + usage.values + usage.tags + usage.includes + usage.strings;
+	return usage;
+}
+
+cfg_memory_usage_t cfg_frozen_memory_usage(cfg_frozen_t *frozen) {
+	cfg_memory_usage_t usage = { 0 };
+	usage.sections = sizeof(cfg_frozen_section_t) * frozen->count;
+	usage.variables = sizeof(cfg_frozen_variable_t) * frozen->variable_count;
+	usage.values = sizeof(double) * frozen->float_count + sizeof(cfg_frozen_value_t) * frozen->value_count +
+	               sizeof(cfg_frozen_list_t) * frozen->list_count;
+	usage.tags = sizeof(uint32_t) * frozen->tag_count;
+	usage.includes = sizeof(uint32_t) * frozen->include_count;
+	usage.strings = frozen->string_size;
+	usage.allocations = frozen->sections ? 1 : 0;
+	usage.total = usage.sections + usage.variables + usage.values + usage.tags + usage.includes + usage.strings;
+	return usage;
 }
 
 #endif // CFG_IMPLEMENTATION
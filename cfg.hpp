@@ -0,0 +1,238 @@
+#ifndef INCLUDE_CFG_HPP
+#define INCLUDE_CFG_HPP
+
+// C++ wrapper for cfg.h. The wrapper is header-only, but the implementation of cfg.h is C, so
+// CFG_IMPLEMENTATION has to be defined in a C file of the program, not in a C++ one.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#endif
+
+#include "cfg.h"
+
+namespace cfg {
+
+// Same FNV hash as cfg_hash, including the sign extension of chars, so both agree on every name
+constexpr uint64_t hash(std::string_view string) {
+	uint64_t hash = 14695981039346656037ULL; // FNV offset basis
+	for (char c : string) {
+		hash ^= (uint64_t)(int32_t)c;
+		hash *= 1099511628211ULL; // FNV prime
+	}
+	return hash;
+}
+
+// A name hashed once, at compile time for string literals
+struct key {
+	uint64_t hash;
+
+	constexpr key(const char *name) : hash(cfg::hash(name)) {}
+	constexpr key(std::string_view name) : hash(cfg::hash(name)) {}
+	constexpr explicit key(uint64_t hash) : hash(hash) {}
+};
+
+namespace literals {
+
+constexpr key operator""_key(const char *name, std::size_t length) {
+	return key(std::string_view(name, length));
+}
+
+} // namespace literals
+
+// Iterates an array of C structs as views
+template <typename View, typename Raw>
+class iterator {
+	Raw *curr;
+
+public:
+	constexpr explicit iterator(Raw *curr) : curr(curr) {}
+	View operator*() const { return View(curr); }
+	iterator &operator++() { ++curr; return *this; }
+	bool operator==(const iterator &other) const { return curr == other.curr; }
+	bool operator!=(const iterator &other) const { return curr != other.curr; }
+};
+
+class value;
+
+// View of a cfg_list_t, does not own the list
+class list {
+	cfg_list_t *raw;
+
+public:
+	explicit list(cfg_list_t *raw) : raw(raw) {}
+	uint32_t size() const { return raw->count; }
+	cfg_value_t *data() const { return raw->values; }
+	value operator[](uint32_t index) const;
+	iterator<value, cfg_value_t> begin() const;
+	iterator<value, cfg_value_t> end() const;
+	cfg_list_t *c_list() const { return raw; }
+#ifdef __cpp_lib_span
+	operator std::span<cfg_value_t>() const { return { raw->values, raw->count }; }
+#endif
+};
+
+// View of a cfg_value_t
+class value {
+	cfg_value_t *raw;
+
+public:
+	explicit value(cfg_value_t *raw) : raw(raw) {}
+	cfg_type_t type() const { return raw->type; }
+	cfg_value_t *c_value() const { return raw; }
+
+	// Empty if the value has another type. Ints widen to double, strings and lists are views, not copies
+	template <typename T>
+	std::optional<T> get() const {
+		if constexpr (std::is_same_v<T, int32_t>) {
+			if (raw->type == CFG_INT)
+				return raw->value_int;
+		} else if constexpr (std::is_same_v<T, double>) {
+			if (raw->type == CFG_FLOAT)
+				return raw->value_float;
+			if (raw->type == CFG_INT)
+				return raw->value_int;
+		} else if constexpr (std::is_same_v<T, bool>) {
+			if (raw->type == CFG_BOOL)
+				return raw->value_bool != 0;
+		} else if constexpr (std::is_same_v<T, std::string_view>) {
+			if (raw->type == CFG_STRING)
+				return std::string_view(raw->value_string ? raw->value_string : "");
+		} else if constexpr (std::is_same_v<T, list>) {
+			if (raw->type == CFG_LIST)
+				return list(raw->value_list);
+		} else {
+			static_assert(!sizeof(T), "cfg::value::get supports int32_t, double, bool, std::string_view and cfg::list");
+		}
+		return std::nullopt;
+	}
+};
+
+inline value list::operator[](uint32_t index) const { return value(&raw->values[index]); }
+inline iterator<value, cfg_value_t> list::begin() const { return iterator<value, cfg_value_t>(raw->values); }
+inline iterator<value, cfg_value_t> list::end() const { return iterator<value, cfg_value_t>(raw->values + raw->count); }
+
+// View of a cfg_variable_t
+class variable {
+	cfg_variable_t *raw;
+
+public:
+	explicit variable(cfg_variable_t *raw) : raw(raw) {}
+	std::string_view name() const { return raw->name; }
+	cfg::value value() const { return cfg::value(&raw->value); }
+	cfg_variable_t *c_variable() const { return raw; }
+
+	template <typename T>
+	std::optional<T> get() const { return value().get<T>(); }
+};
+
+// View of a cfg_section_t
+class section {
+	cfg_section_t *raw;
+
+public:
+	explicit section(cfg_section_t *raw) : raw(raw) {}
+	std::string_view name() const { return raw->name; }
+	uint32_t size() const { return raw->count; }
+	cfg_section_t *c_section() const { return raw; }
+
+	std::optional<variable> find(key name) const {
+		cfg_variable_t *found = cfg_variable_get_hash(raw, name.hash);
+		if (!found)
+			return std::nullopt;
+		return variable(found);
+	}
+
+	template <typename T>
+	std::optional<T> get(key name) const {
+		cfg_variable_t *found = cfg_variable_get_hash(raw, name.hash);
+		if (!found)
+			return std::nullopt;
+		return cfg::value(&found->value).get<T>();
+	}
+
+	template <typename T>
+	T get(key name, T fallback) const { return get<T>(name).value_or(fallback); }
+
+	iterator<variable, cfg_variable_t> begin() const { return iterator<variable, cfg_variable_t>(raw->variables); }
+	iterator<variable, cfg_variable_t> end() const { return iterator<variable, cfg_variable_t>(raw->variables + raw->count); }
+
+	std::string_view tag(uint32_t index) const { return raw->tags[index]; }
+	uint32_t tag_count() const { return raw->tag_count; }
+};
+
+// Owns a cfg_data_t and frees it, can be moved but not copied
+class document {
+	cfg_data_t raw = {};
+
+public:
+	document() = default;
+	explicit document(cfg_data_t data) : raw(data) {}
+	~document() { cfg_data_free(&raw); }
+
+	document(const document &) = delete;
+	document &operator=(const document &) = delete;
+	document(document &&other) noexcept : raw(other.release()) {}
+	document &operator=(document &&other) noexcept {
+		if (this != &other) {
+			cfg_data_free(&raw);
+			raw = other.release();
+		}
+		return *this;
+	}
+
+	static document read(const char *source) { return document(cfg_data_read(const_cast<char *>(source))); }
+	static document read(const std::string &source) { return read(source.c_str()); }
+	static document read_file(const char *path) { return document(cfg_data_read_file(const_cast<char *>(path))); }
+
+	std::string write() const {
+		char *buffer = cfg_data_write(raw);
+		std::string string(buffer ? buffer : "");
+		free(buffer);
+		return string;
+	}
+	bool write_file(const char *path) const { return cfg_data_write_file(const_cast<char *>(path), raw); }
+
+	uint32_t size() const { return raw.count; }
+	cfg_data_t *c_data() { return &raw; }
+	const cfg_data_t *c_data() const { return &raw; }
+
+	// Gives up ownership, the caller has to free the data
+	cfg_data_t release() {
+		cfg_data_t data = raw;
+		raw = {};
+		return data;
+	}
+
+	std::optional<cfg::section> find(key name) const {
+		cfg_section_t *found = cfg_section_get_hash(const_cast<cfg_data_t *>(&raw), name.hash);
+		if (!found)
+			return std::nullopt;
+		return cfg::section(found);
+	}
+
+	template <typename T>
+	std::optional<T> get(key section, key name) const {
+		cfg_section_t *found = cfg_section_get_hash(const_cast<cfg_data_t *>(&raw), section.hash);
+		if (!found)
+			return std::nullopt;
+		return cfg::section(found).get<T>(name);
+	}
+
+	template <typename T>
+	T get(key section, key name, T fallback) const { return get<T>(section, name).value_or(fallback); }
+
+	iterator<cfg::section, cfg_section_t> begin() const { return iterator<cfg::section, cfg_section_t>(raw.sections); }
+	iterator<cfg::section, cfg_section_t> end() const { return iterator<cfg::section, cfg_section_t>(raw.sections + raw.count); }
+};
+
+} // namespace cfg
+
+#endif // INCLUDE_CFG_HPP
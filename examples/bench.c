@@ -0,0 +1,665 @@
+/*
+ Benchmark suite for cfg.
+
+ Generates a synthetic config of controllable shape (or loads an existing one) and measures parsing,
+ writing, round-tripping, lookups, freeing, freezing and the memory used by the parsed and the frozen
+ document, diffing and patching with a few changed values, populating structs through the tree and with
+ cfg_bind, and reading a directory of small files one by one and as a batch. Every result is printed as
+ one JSON object per line, so the output of two releases can be compared with any line based tool.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#define CFG_IMPLEMENTATION
+#include "../cfg.h"
+
+typedef struct bench_shape bench_shape_t;
+typedef struct bench_server bench_server_t;
+
+struct bench_shape {
+	uint32_t sections;
+	uint32_t variables;   // Variables per section
+	uint32_t strings;     // Percentage of scalar values that are strings, the rest are numbers and booleans
+	uint32_t lists;       // Percentage of values that are lists
+	uint32_t depth;       // Maximum list nesting depth
+	uint32_t tags;        // Percentage of sections that carry tags
+	uint64_t seed;
+};
+
+// Struct and schema as generated by schema.c from the server section of schema.cfg
+struct bench_server {
+	char *name;
+	char *host;
+	int32_t port;
+	double timeout;
+	uint8_t tls;
+	cfg_list_t *aliases;
+};
+
+static cfg_field_t bench_server_fields[] = {
+	{ "name", CFG_STRING, offsetof(bench_server_t, name), { 0 } },
+	{ "host", CFG_STRING, offsetof(bench_server_t, host), { CFG_STRING, { .value_string = "localhost" } } },
+	{ "port", CFG_INT, offsetof(bench_server_t, port), { CFG_INT, { .value_int = 8080 } } },
+	{ "timeout", CFG_FLOAT, offsetof(bench_server_t, timeout), { CFG_FLOAT, { .value_float = 2.5 } } },
+	{ "tls", CFG_BOOL, offsetof(bench_server_t, tls), { CFG_BOOL, { .value_bool = 0 } } },
+	{ "aliases", CFG_LIST, offsetof(bench_server_t, aliases), { 0 } },
+};
+
+static cfg_schema_t bench_server_schema = { sizeof(bench_server_t), 6, bench_server_fields };
+
+static uint64_t rng_state;
+
+static uint64_t rng_next(void) {
+	// xorshift64*
+	rng_state ^= rng_state >> 12;
+	rng_state ^= rng_state << 25;
+	rng_state ^= rng_state >> 27;
+	return rng_state * 2685821657736338717ULL;
+}
+
+static uint32_t rng_range(uint32_t n) {
+	return n ? (uint32_t)(rng_next() % n) : 0;
+}
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Peak of the whole process so far, not of the benchmark that reports it: later lines repeat earlier maxima
+static long process_peak_rss_kb(void) {
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+}
+
+// Identifiers may not contain digits, dots or dashes, so numbers are spelled with letters
+static char *gen_name(char *buffer, char *prefix, uint32_t n) {
+	buffer = _cfg_string_append(buffer, "%s", prefix);
+	do {
+		buffer = _cfg_string_append_char(buffer, 'a' + n % 26);
+		n /= 26;
+	} while (n);
+	return buffer;
+}
+
+static char *gen_string(char *buffer) {
+	static char *words[] = { "alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel" };
+	uint32_t count = 1 + rng_range(4);
+	buffer = _cfg_string_append_char(buffer, '"');
+	for (uint32_t i = 0; i < count; ++i)
+		buffer = _cfg_string_append(buffer, i ? " %s" : "%s", words[rng_range(8)]);
+	return _cfg_string_append_char(buffer, '"');
+}
+
+static char *gen_value(char *buffer, bench_shape_t *shape, uint32_t depth) {
+	if (depth < shape->depth && rng_range(100) < shape->lists) {
+		uint32_t count = rng_range(6);
+		buffer = _cfg_string_append_char(buffer, '(');
+		for (uint32_t i = 0; i < count; ++i) {
+			if (i)
+				buffer = _cfg_string_append_char(buffer, ' ');
+			buffer = gen_value(buffer, shape, depth + 1);
+		}
+		return _cfg_string_append_char(buffer, ')');
+	}
+
+	if (rng_range(100) < shape->strings)
+		return gen_string(buffer);
+
+	switch (rng_range(3)) {
+	case 0:
+		return _cfg_string_append(buffer, "%u", rng_range(100000));
+	case 1:
+		return _cfg_string_append(buffer, "%u.%03u", rng_range(1000), rng_range(1000));
+	default:
+		return _cfg_string_append(buffer, "%s", _cfg_string_bool(rng_range(2)));
+	}
+}
+
+static char *gen_config(bench_shape_t *shape) {
+	char *buffer = NULL;
+	rng_state = shape->seed ? shape->seed : 1;
+
+	for (uint32_t s = 0; s < shape->sections; ++s) {
+		if (rng_range(100) < shape->tags) {
+			uint32_t tag_count = 1 + rng_range(3);
+			for (uint32_t t = 0; t < tag_count; ++t) {
+				buffer = gen_name(buffer, "@tag", rng_range(16));
+				buffer = _cfg_string_append_char(buffer, '\n');
+			}
+		}
+		buffer = _cfg_string_append(buffer, "[Section ");
+		buffer = gen_name(buffer, "", s);
+		buffer = _cfg_string_append(buffer, "]\n");
+
+		for (uint32_t v = 0; v < shape->variables; ++v) {
+			buffer = gen_name(buffer, "key_", v);
+			buffer = _cfg_string_append(buffer, " = ");
+			buffer = gen_value(buffer, shape, 0);
+			buffer = _cfg_string_append_char(buffer, '\n');
+		}
+		buffer = _cfg_string_append_char(buffer, '\n');
+	}
+
+	return buffer;
+}
+
+static char *read_source(char *path) {
+	FILE *f = fopen(path, "rb");
+	if (!f)
+		return NULL;
+	fseek(f, 0, SEEK_END);
+	uint64_t fsize = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	char *source = malloc(fsize + 1);
+	fsize = fread(source, 1, fsize, f);
+	fclose(f);
+	source[fsize] = 0;
+	return source;
+}
+
+static void report_throughput(char *name, uint32_t iterations, uint64_t bytes, double seconds) {
+	printf("{\"benchmark\":\"%s\",\"iterations\":%u,\"bytes\":%lu,\"seconds\":%.6f,\"mb_per_s\":%.2f,\"process_peak_rss_kb\":%ld}\n",
+	       name, iterations, (unsigned long)bytes, seconds, bytes * (double)iterations / seconds / 1e6, process_peak_rss_kb());
+}
+
+static void bench_parse(char *source, uint32_t iterations) {
+	uint64_t bytes = strlen(source);
+	double start = now();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		cfg_data_t data = cfg_data_read(source);
+		cfg_data_free(&data);
+	}
+	report_throughput("parse", iterations, bytes, now() - start);
+}
+
+static void bench_write(cfg_data_t data, uint32_t iterations) {
+	uint64_t bytes = 0;
+	double start = now();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		char *output = cfg_data_write(data);
+		bytes = output ? strlen(output) : 0;
+		free(output);
+	}
+	report_throughput("write", iterations, bytes, now() - start);
+}
+
+static void bench_round_trip(cfg_data_t data, uint32_t iterations) {
+	uint64_t bytes = 0;
+	double start = now();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		char *output = cfg_data_write(data);
+		bytes = output ? strlen(output) : 0;
+		cfg_data_t copy = cfg_data_read(output);
+		if (copy.count != data.count)
+			fprintf(stderr, "round-trip: %u sections read back, expected %u\n", copy.count, data.count);
+		cfg_data_free(&copy);
+		free(output);
+	}
+	report_throughput("round_trip", iterations, bytes, now() - start);
+}
+
+static void report_lookup(char *name, uint64_t lookups, uint64_t found, double seconds) {
+	printf("{\"benchmark\":\"%s\",\"lookups\":%lu,\"found\":%lu,\"seconds\":%.6f,\"ns_per_lookup\":%.2f,\"process_peak_rss_kb\":%ld}\n",
+	       name, (unsigned long)lookups, (unsigned long)found, seconds, seconds * 1e9 / lookups, process_peak_rss_kb());
+}
+
+static void bench_lookup(cfg_data_t data, uint32_t iterations) {
+	// Collect every (section, variable) name pair and probe them in a random order
+	uint64_t key_count = 0;
+	for (uint32_t s = 0; s < data.count; ++s)
+		key_count += data.sections[s].count;
+	if (!key_count)
+		return;
+
+	char **keys = malloc(sizeof(char *) * key_count * 2);
+	uint64_t k = 0;
+	for (uint32_t s = 0; s < data.count; ++s) {
+		for (uint32_t v = 0; v < data.sections[s].count; ++v) {
+			keys[k * 2] = data.sections[s].name;
+			keys[k * 2 + 1] = data.sections[s].variables[v].name;
+			++k;
+		}
+	}
+	for (uint64_t i = key_count - 1; i > 0; --i) {
+		uint64_t j = rng_next() % (i + 1);
+		char *section = keys[i * 2], *variable = keys[i * 2 + 1];
+		keys[i * 2] = keys[j * 2];
+		keys[i * 2 + 1] = keys[j * 2 + 1];
+		keys[j * 2] = section;
+		keys[j * 2 + 1] = variable;
+	}
+
+	uint64_t found = 0;
+	double start = now();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		for (k = 0; k < key_count; ++k) {
+			cfg_section_t *section = cfg_section_get(&data, keys[k * 2]);
+			if (section && cfg_variable_get(section, keys[k * 2 + 1]))
+				++found;
+		}
+	}
+	report_lookup("lookup", key_count * iterations, found, now() - start);
+
+	// The same probes against the frozen form of the document
+	cfg_frozen_t frozen = cfg_data_freeze(&data);
+	found = 0;
+	start = now();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		for (k = 0; k < key_count; ++k) {
+			cfg_frozen_section_t *section = cfg_frozen_section_get(&frozen, keys[k * 2]);
+			if (section && cfg_frozen_variable_get(&frozen, section, keys[k * 2 + 1]))
+				++found;
+		}
+	}
+	report_lookup("frozen_lookup", key_count * iterations, found, now() - start);
+
+	cfg_frozen_free(&frozen);
+	free(keys);
+}
+
+static void bench_free(char *source, uint32_t iterations) {
+	cfg_data_t *copies = malloc(sizeof(cfg_data_t) * iterations);
+	for (uint32_t i = 0; i < iterations; ++i)
+		copies[i] = cfg_data_read(source);
+
+	double start = now();
+	for (uint32_t i = 0; i < iterations; ++i)
+		cfg_data_free(&copies[i]);
+	report_throughput("free", iterations, strlen(source), now() - start);
+	free(copies);
+}
+
+static void bench_freeze(char *source, cfg_data_t data, uint32_t iterations) {
+	double start = now();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		cfg_frozen_t frozen = cfg_data_freeze(&data);
+		cfg_frozen_free(&frozen);
+	}
+	report_throughput("freeze", iterations, strlen(source), now() - start);
+}
+
+static void report_memory(char *name, uint64_t source_bytes, cfg_memory_usage_t usage) {
+	printf("{\"benchmark\":\"%s\",\"sections\":%lu,\"variables\":%lu,\"values\":%lu,\"tags\":%lu,\"includes\":%lu,"
+	       "\"strings\":%lu,\"allocations\":%lu,\"total\":%lu,\"source_ratio\":%.2f}\n",
+	       name, (unsigned long)usage.sections, (unsigned long)usage.variables, (unsigned long)usage.values,
+	       (unsigned long)usage.tags, (unsigned long)usage.includes, (unsigned long)usage.strings,
+	       (unsigned long)usage.allocations, (unsigned long)usage.total, usage.total / (double)source_bytes);
+}
+
+// Bytes used by the parsed and by the frozen document, relative to the size of the source
+static void bench_memory(char *source, cfg_data_t data) {
+	cfg_frozen_t frozen = cfg_data_freeze(&data);
+	report_memory("memory", strlen(source), cfg_data_memory_usage(&data));
+	report_memory("frozen_memory", strlen(source), cfg_frozen_memory_usage(&frozen));
+	cfg_frozen_free(&frozen);
+}
+
+static void report_operation(char *name, uint32_t iterations, uint32_t entries, double seconds) {
+	printf("{\"benchmark\":\"%s\",\"iterations\":%u,\"entries\":%u,\"seconds\":%.6f,\"us_per_op\":%.2f,\"process_peak_rss_kb\":%ld}\n",
+	       name, iterations, entries, seconds, seconds * 1e6 / iterations, process_peak_rss_kb());
+}
+
+// A patched document must write the same text as the target, and diff against it without entries, which also
+// catches values that differ by less than the writer prints
+static void verify_patched(char *name, cfg_data_t *data, cfg_data_t *to, char *expected) {
+	char *output = cfg_data_write(*data);
+	cfg_patch_t rest = cfg_data_diff(data, to);
+	if (rest.count || strcmp(output ? output : "", expected ? expected : ""))
+		fprintf(stderr, "%s: patched document differs from the target\n", name);
+	cfg_patch_free(&rest);
+	free(output);
+}
+
+static void verify_patch(char *name, char *source, cfg_patch_t patch, cfg_data_t *to, char *expected) {
+	cfg_data_t data = cfg_data_read(source);
+	if (!cfg_data_patch(&data, patch))
+		fprintf(stderr, "%s: not every entry could be applied\n", name);
+	verify_patched(name, &data, to, expected);
+	cfg_data_free(&data);
+}
+
+// Diff a document against a copy with a few changed values, then apply and serialize the patch
+static void bench_diff_patch(char *source, uint32_t iterations, uint32_t changes) {
+	cfg_data_t from = cfg_data_read(source), to = cfg_data_read(source);
+	if (!to.count)
+		return;
+	for (uint32_t c = 0; c < changes; ++c) {
+		cfg_section_t *section = &to.sections[rng_range(to.count)];
+		if (!section->count)
+			continue;
+		cfg_variable_t *variable = &section->variables[rng_range(section->count)];
+		_cfg_value_free(&variable->value);
+		// Half of the changes are floats that differ only in their last digits, which lossy writers drop
+		if (c & 1)
+			variable->value = (cfg_value_t) { CFG_FLOAT, { .value_float = 1 + rng_range(100000) * 1e-12 } };
+		else
+			variable->value = (cfg_value_t) { CFG_INT, { .value_int = (int32_t)rng_range(100000) - 50000 } };
+	}
+	char *expected = cfg_data_write(to);
+
+	cfg_patch_t patch = { 0 };
+	double start = now();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		cfg_patch_free(&patch);
+		patch = cfg_data_diff(&from, &to);
+	}
+	report_operation("diff", iterations, patch.count, now() - start);
+
+	cfg_data_t *copies = malloc(sizeof(cfg_data_t) * iterations);
+	for (uint32_t i = 0; i < iterations; ++i)
+		copies[i] = cfg_data_read(source);
+	start = now();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		if (!cfg_data_patch(&copies[i], patch))
+			fprintf(stderr, "patch: not every entry could be applied\n");
+	}
+	report_operation("patch", iterations, patch.count, now() - start);
+	verify_patched("patch", &copies[0], &to, expected);
+	for (uint32_t i = 0; i < iterations; ++i)
+		cfg_data_free(&copies[i]);
+	free(copies);
+
+	uint64_t bytes = 0;
+	start = now();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		char *text = cfg_patch_write(patch);
+		bytes = text ? strlen(text) : 0;
+		cfg_patch_t copy = cfg_patch_read(text ? text : "");
+		cfg_patch_free(&copy);
+		free(text);
+	}
+	report_throughput("patch_text", iterations, bytes, now() - start);
+	char *text = cfg_patch_write(patch);
+	cfg_patch_t text_copy = cfg_patch_read(text ? text : "");
+	verify_patch("patch_text", source, text_copy, &to, expected);
+	cfg_patch_free(&text_copy);
+	free(text);
+
+	start = now();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		uint8_t *binary = cfg_patch_write_binary(patch, &bytes);
+		cfg_patch_t copy = cfg_patch_read_binary(binary, bytes);
+		cfg_patch_free(&copy);
+		free(binary);
+	}
+	report_throughput("patch_binary", iterations, bytes, now() - start);
+	uint8_t *binary = cfg_patch_write_binary(patch, &bytes);
+	cfg_patch_t binary_copy = cfg_patch_read_binary(binary, bytes);
+	verify_patch("patch_binary", source, binary_copy, &to, expected);
+	cfg_patch_free(&binary_copy);
+	free(binary);
+
+	free(expected);
+	cfg_patch_free(&patch);
+	cfg_data_free(&from);
+	cfg_data_free(&to);
+}
+
+// The generated names never repeat, so the occurrence matching of duplicate names is checked on small
+// documents instead. Their targets also move variables and sections, which patches do not reproduce, so
+// only the diff against the target has to come out empty
+static void verify_duplicates(void) {
+	static char *documents[][2] = {
+		{ "[s]\nz = 0\nx = 1\n", "[s]\nx = 1\nx = 2\nz = 0\n" },
+		{ "[z]\n[s]\nx = 1\n", "[s]\nx = 1\n[s]\nx = 2\n[z]\n" },
+		{ "[s]\nx = 1\n[t]\n[s]\ny = 1\n", "[s]\nx = 2\n[s]\n[s]\ny = 1\nx = 1\nx = 3\n" },
+	};
+	for (uint32_t d = 0; d < sizeof(documents) / sizeof(documents[0]); ++d) {
+		cfg_data_t from = cfg_data_read(documents[d][0]), to = cfg_data_read(documents[d][1]);
+		cfg_patch_t patch = cfg_data_diff(&from, &to);
+		char *text = cfg_patch_write(patch);
+		cfg_patch_t copy = cfg_patch_read(text ? text : "");
+
+		cfg_patch_t patches[] = { patch, copy };
+		for (uint32_t p = 0; p < 2; ++p) {
+			cfg_data_t data = cfg_data_read(documents[d][0]);
+			uint8_t applied = cfg_data_patch(&data, patches[p]);
+			cfg_patch_t rest = cfg_data_diff(&data, &to);
+			if (!applied || rest.count)
+				fprintf(stderr, "duplicates: patched document %u differs from the target\n", d);
+			cfg_patch_free(&rest);
+			cfg_data_free(&data);
+		}
+
+		cfg_patch_free(&copy);
+		free(text);
+		cfg_patch_free(&patch);
+		cfg_data_free(&from);
+		cfg_data_free(&to);
+	}
+}
+
+// Read a directory of small generated configs one by one and as a batch
+static void bench_batch(bench_shape_t *shape, uint32_t files) {
+	char directory[] = "/tmp/cfg-bench-XXXXXX";
+	if (!mkdtemp(directory)) {
+		fprintf(stderr, "batch: could not create a temporary directory\n");
+		return;
+	}
+
+	bench_shape_t file_shape = *shape;
+	file_shape.sections = 4;
+	file_shape.variables = 8;
+	uint64_t bytes = 0;
+	char **paths = malloc(sizeof(char *) * files);
+	for (uint32_t i = 0; i < files; ++i) {
+		file_shape.seed = shape->seed + i + 1;
+		char *source = gen_config(&file_shape);
+		paths[i] = _cfg_string_append(NULL, "%s/host%u.cfg", directory, i);
+		FILE *f = fopen(paths[i], "w");
+		if (f) {
+			fputs(source, f);
+			fclose(f);
+		}
+		bytes += strlen(source);
+		free(source);
+	}
+
+	cfg_file_result_t *results = malloc(sizeof(cfg_file_result_t) * files);
+	double start = now();
+	for (uint32_t i = 0; i < files; ++i)
+		results[i].data = cfg_data_read_file(paths[i]);
+	double seconds = now() - start;
+	for (uint32_t i = 0; i < files; ++i)
+		cfg_data_free(&results[i].data);
+	printf("{\"benchmark\":\"read_file\",\"files\":%u,\"bytes\":%lu,\"seconds\":%.6f,\"files_per_s\":%.0f,\"mb_per_s\":%.2f,\"process_peak_rss_kb\":%ld}\n",
+	       files, (unsigned long)bytes, seconds, files / seconds, bytes / seconds / 1e6, process_peak_rss_kb());
+
+	start = now();
+	uint32_t read = cfg_data_read_files(paths, files, results);
+	seconds = now() - start;
+	for (uint32_t i = 0; i < files; ++i)
+		cfg_data_free(&results[i].data);
+#ifdef CFG_THREADS
+	long threads = CFG_THREADS > 0 ? (long)CFG_THREADS : sysconf(_SC_NPROCESSORS_ONLN);
+#else
+	long threads = 1;
+#endif
+	printf("{\"benchmark\":\"read_files\",\"files\":%u,\"read\":%u,\"threads\":%ld,\"bytes\":%lu,\"seconds\":%.6f,\"files_per_s\":%.0f,\"mb_per_s\":%.2f,\"process_peak_rss_kb\":%ld}\n",
+	       files, read, threads, (unsigned long)bytes, seconds, files / seconds, bytes / seconds / 1e6, process_peak_rss_kb());
+
+	for (uint32_t i = 0; i < files; ++i) {
+		unlink(paths[i]);
+		free(paths[i]);
+	}
+	rmdir(directory);
+	free(results);
+	free(paths);
+}
+
+// What binding looks like without cfg_bind: build the tree, then look up and type check every field
+static void bind_tree(cfg_data_t *data, bench_server_t *servers) {
+	for (uint32_t s = 0; s < data->count; ++s) {
+		cfg_section_t *section = &data->sections[s];
+		bench_server_t *server = &servers[s];
+		cfg_variable_t *variable;
+
+		variable = cfg_variable_get(section, "name");
+		server->name = variable && variable->value.type == CFG_STRING ? _cfg_string_copy(variable->value.value_string) : NULL;
+		variable = cfg_variable_get(section, "host");
+		server->host = _cfg_string_copy(variable && variable->value.type == CFG_STRING ? variable->value.value_string : "localhost");
+		variable = cfg_variable_get(section, "port");
+		server->port = variable && variable->value.type == CFG_INT ? variable->value.value_int : 8080;
+		variable = cfg_variable_get(section, "timeout");
+		server->timeout = variable && variable->value.type == CFG_FLOAT ? variable->value.value_float :
+		                  variable && variable->value.type == CFG_INT ? variable->value.value_int : 2.5;
+		variable = cfg_variable_get(section, "tls");
+		server->tls = variable && variable->value.type == CFG_BOOL ? variable->value.value_bool : 0;
+		variable = cfg_variable_get(section, "aliases");
+		server->aliases = variable && variable->value.type == CFG_LIST ? _cfg_list_clone(variable->value.value_list) : NULL;
+	}
+}
+
+// Populate structs from a config of server sections, through the tree and with cfg_bind
+static void bench_bind(uint32_t structs, uint32_t iterations) {
+	char *source = NULL;
+	for (uint32_t s = 0; s < structs; ++s) {
+		source = _cfg_string_append(source, "[Server ");
+		source = gen_name(source, "", s);
+		source = _cfg_string_append(source, "]\nname = ");
+		source = gen_string(source);
+		if (rng_range(2)) {
+			source = _cfg_string_append(source, "\nhost = ");
+			source = gen_string(source);
+		}
+		source = _cfg_string_append(source, "\nport = %u\ntimeout = %u.%03u\n", rng_range(65536), rng_range(60), rng_range(1000));
+		if (rng_range(2))
+			source = _cfg_string_append(source, "tls = %s\n", _cfg_string_bool(rng_range(2)));
+		if (rng_range(4) == 0)
+			source = _cfg_string_append(source, "aliases = (\"a\" \"b\")\n");
+		source = _cfg_string_append(source, "\n");
+	}
+
+	uint64_t bytes = strlen(source);
+	bench_server_t *servers = malloc(sizeof(bench_server_t) * structs);
+
+	double start = now();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		cfg_data_t data = cfg_data_read(source);
+		bind_tree(&data, servers);
+		cfg_data_free(&data);
+		cfg_bind_free(&bench_server_schema, servers, structs);
+	}
+	double seconds = now() - start;
+	printf("{\"benchmark\":\"bind_tree\",\"iterations\":%u,\"structs\":%u,\"bytes\":%lu,\"seconds\":%.6f,\"ns_per_struct\":%.2f,\"process_peak_rss_kb\":%ld}\n",
+	       iterations, structs, (unsigned long)bytes, seconds, seconds * 1e9 / ((double)structs * iterations), process_peak_rss_kb());
+
+	uint32_t bound = 0;
+	start = now();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		bound = cfg_bind(source, NULL, &bench_server_schema, servers, structs);
+		cfg_bind_free(&bench_server_schema, servers, bound);
+	}
+	seconds = now() - start;
+	printf("{\"benchmark\":\"bind\",\"iterations\":%u,\"structs\":%u,\"bytes\":%lu,\"seconds\":%.6f,\"ns_per_struct\":%.2f,\"process_peak_rss_kb\":%ld}\n",
+	       iterations, bound, (unsigned long)bytes, seconds, seconds * 1e9 / ((double)structs * iterations), process_peak_rss_kb());
+
+	free(servers);
+	free(source);
+}
+
+static void usage(char *program) {
+	fprintf(stderr,
+	        "usage: %s [options]\n"
+	        "  -s N     sections (default 256)\n"
+	        "  -v N     variables per section (default 16)\n"
+	        "  -r P     percentage of scalar values that are strings (default 50)\n"
+	        "  -l P     percentage of values that are lists (default 20)\n"
+	        "  -d N     maximum list nesting depth (default 2)\n"
+	        "  -t P     percentage of sections with tags (default 25)\n"
+	        "  -S N     generator seed (default 1)\n"
+	        "  -n N     iterations per benchmark (default 10)\n"
+	        "  -c N     values changed for the diff and patch benchmarks (default 16)\n"
+	        "  -B N     structs populated by the binding benchmarks, 0 skips them (default 5000)\n"
+	        "  -F N     small files generated for the batch read benchmarks, 0 skips them (default 10000)\n"
+	        "  -i FILE  benchmark an existing config instead of a generated one\n"
+	        "  -o FILE  write the generated config to FILE and exit\n",
+	        program);
+}
+
+int main(int argc, char *argv[]) {
+	bench_shape_t shape = { 256, 16, 50, 20, 2, 25, 1 };
+	uint32_t iterations = 10, changes = 16, structs = 5000, files = 10000;
+	char *input = NULL, *output = NULL;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "s:v:r:l:d:t:S:n:c:B:F:i:o:h")) != -1) {
+		switch (opt) {
+		case 's': shape.sections = strtoul(optarg, NULL, 10); break;
+		case 'v': shape.variables = strtoul(optarg, NULL, 10); break;
+		case 'r': shape.strings = strtoul(optarg, NULL, 10); break;
+		case 'l': shape.lists = strtoul(optarg, NULL, 10); break;
+		case 'd': shape.depth = strtoul(optarg, NULL, 10); break;
+		case 't': shape.tags = strtoul(optarg, NULL, 10); break;
+		case 'S': shape.seed = strtoull(optarg, NULL, 10); break;
+		case 'n': iterations = strtoul(optarg, NULL, 10); break;
+		case 'c': changes = strtoul(optarg, NULL, 10); break;
+		case 'B': structs = strtoul(optarg, NULL, 10); break;
+		case 'F': files = strtoul(optarg, NULL, 10); break;
+		case 'i': input = optarg; break;
+		case 'o': output = optarg; break;
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (!iterations)
+		iterations = 1;
+
+	char *source = input ? read_source(input) : gen_config(&shape);
+	if (!source) {
+		fprintf(stderr, "%s: could not read %s\n", argv[0], input);
+		return 1;
+	}
+
+	if (output) {
+		FILE *f = fopen(output, "w");
+		if (!f) {
+			fprintf(stderr, "%s: could not write %s\n", argv[0], output);
+			return 1;
+		}
+		fputs(source, f);
+		fclose(f);
+		free(source);
+		return 0;
+	}
+
+	cfg_data_t data = cfg_data_read(source);
+	uint64_t variables = 0;
+	for (uint32_t s = 0; s < data.count; ++s)
+		variables += data.sections[s].count;
+
+	if (input)
+		printf("{\"benchmark\":\"config\",\"input\":\"%s\",\"bytes\":%lu,\"sections\":%u,\"variables\":%lu}\n",
+		       input, (unsigned long)strlen(source), data.count, (unsigned long)variables);
+	else
+		printf("{\"benchmark\":\"config\",\"bytes\":%lu,\"sections\":%u,\"variables\":%lu,"
+		       "\"strings\":%u,\"lists\":%u,\"depth\":%u,\"tags\":%u,\"seed\":%lu}\n",
+		       (unsigned long)strlen(source), data.count, (unsigned long)variables,
+		       shape.strings, shape.lists, shape.depth, shape.tags, (unsigned long)shape.seed);
+
+	bench_parse(source, iterations);
+	bench_write(data, iterations);
+	bench_round_trip(data, iterations);
+	bench_lookup(data, iterations);
+	bench_free(source, iterations);
+	bench_freeze(source, data, iterations);
+	bench_memory(source, data);
+	bench_diff_patch(source, iterations, changes);
+	verify_duplicates();
+	if (structs)
+		bench_bind(structs, iterations);
+	if (files)
+		bench_batch(&shape, files);
+
+	cfg_data_free(&data);
+	free(source);
+	return 0;
+}
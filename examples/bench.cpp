@@ -0,0 +1,172 @@
+/*
+ Benchmark of cfg.hpp against hand-written C access through cfg.h.
+
+ Looks up the same variables with runtime hashing (cfg_section_get), with hashes computed once at startup
+ (cfg_section_get_hash, what careful C code does) and with cfg.hpp and compile-time keys, then iterates all
+ variables with C loops and with range-based for. Results are printed as one JSON object per line, like bench.c.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "../cfg.hpp"
+
+using namespace cfg::literals;
+
+static constexpr uint32_t section_count = 16, variable_count = 16;
+
+static const char *section_names[section_count] = {
+	"Section a", "Section b", "Section c", "Section d", "Section e", "Section f", "Section g", "Section h",
+	"Section i", "Section j", "Section k", "Section l", "Section m", "Section n", "Section o", "Section p"
+};
+
+static const char *variable_names[variable_count] = {
+	"key_a", "key_b", "key_c", "key_d", "key_e", "key_f", "key_g", "key_h",
+	"key_i", "key_j", "key_k", "key_l", "key_m", "key_n", "key_o", "key_p"
+};
+
+static constexpr cfg::key section_keys[section_count] = {
+	"Section a"_key, "Section b"_key, "Section c"_key, "Section d"_key, "Section e"_key, "Section f"_key, "Section g"_key, "Section h"_key,
+	"Section i"_key, "Section j"_key, "Section k"_key, "Section l"_key, "Section m"_key, "Section n"_key, "Section o"_key, "Section p"_key
+};
+
+static constexpr cfg::key variable_keys[variable_count] = {
+	"key_a"_key, "key_b"_key, "key_c"_key, "key_d"_key, "key_e"_key, "key_f"_key, "key_g"_key, "key_h"_key,
+	"key_i"_key, "key_j"_key, "key_k"_key, "key_l"_key, "key_m"_key, "key_n"_key, "key_o"_key, "key_p"_key
+};
+
+static double now() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Variables cycle through int, float, string, bool and list
+static std::string gen_config() {
+	std::string source;
+	for (uint32_t s = 0; s < section_count; ++s) {
+		source += std::string("[") + section_names[s] + "]\n";
+		for (uint32_t v = 0; v < variable_count; ++v) {
+			source += std::string(variable_names[v]) + " = ";
+			switch (v % 5) {
+			case 0: source += std::to_string(s * 100 + v); break;
+			case 1: source += std::to_string(s) + ".25"; break;
+			case 2: source += "\"value of " + std::string(variable_names[v]) + "\""; break;
+			case 3: source += (v & 1) ? "true" : "false"; break;
+			default: source += "(1 2 3 \"four\")"; break;
+			}
+			source += "\n";
+		}
+		source += "\n";
+	}
+	return source;
+}
+
+static void report(const char *name, uint64_t lookups, double seconds, double sum) {
+	printf("{\"benchmark\":\"%s\",\"lookups\":%lu,\"seconds\":%.6f,\"ns_per_lookup\":%.2f,\"checksum\":%.0f}\n",
+	       name, (unsigned long)lookups, seconds, seconds * 1e9 / lookups, sum);
+}
+
+static double accumulate_c(cfg_variable_t *variable, uint32_t v) {
+	if (!variable)
+		return 0;
+	cfg_value_t value = variable->value;
+	switch (v % 5) {
+	case 0: return value.type == CFG_INT ? value.value_int : 0;
+	case 1: return value.type == CFG_FLOAT ? value.value_float : value.type == CFG_INT ? value.value_int : 0;
+	case 2: return value.type == CFG_STRING ? strlen(value.value_string) : 0;
+	case 3: return value.type == CFG_BOOL ? value.value_bool : 0;
+	default: return value.type == CFG_LIST ? value.value_list->count : 0;
+	}
+}
+
+int main(int argc, char *argv[]) {
+	uint32_t iterations = argc > 1 ? strtoul(argv[1], NULL, 10) : 100000;
+	std::string source = gen_config();
+	cfg::document document = cfg::document::read(source);
+	cfg_data_t *data = document.c_data();
+	uint64_t lookups = (uint64_t)iterations * section_count * variable_count;
+
+	// The hashes must agree, otherwise cfg.hpp would not find what cfg.h stores
+	if (cfg_hash((char *)variable_names[0]) != variable_keys[0].hash) {
+		fprintf(stderr, "cfg::hash and cfg_hash disagree\n");
+		return 1;
+	}
+
+	// C, hashing both names on every lookup
+	double sum = 0, start = now();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		for (uint32_t s = 0; s < section_count; ++s) {
+			cfg_section_t *section = cfg_section_get(data, (char *)section_names[s]);
+			for (uint32_t v = 0; v < variable_count; ++v)
+				sum += accumulate_c(section ? cfg_variable_get(section, (char *)variable_names[v]) : NULL, v);
+		}
+	}
+	report("c_runtime_hash", lookups, now() - start, sum);
+
+	// C, with the hashes computed once up front
+	uint64_t section_hashes[section_count], variable_hashes[variable_count];
+	for (uint32_t s = 0; s < section_count; ++s)
+		section_hashes[s] = cfg_hash((char *)section_names[s]);
+	for (uint32_t v = 0; v < variable_count; ++v)
+		variable_hashes[v] = cfg_hash((char *)variable_names[v]);
+
+	sum = 0;
+	start = now();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		for (uint32_t s = 0; s < section_count; ++s) {
+			cfg_section_t *section = cfg_section_get_hash(data, section_hashes[s]);
+			for (uint32_t v = 0; v < variable_count; ++v)
+				sum += accumulate_c(section ? cfg_variable_get_hash(section, variable_hashes[v]) : NULL, v);
+		}
+	}
+	report("c_hash", lookups, now() - start, sum);
+
+	// C++, with compile-time keys and typed accessors
+	sum = 0;
+	start = now();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		for (uint32_t s = 0; s < section_count; ++s) {
+			std::optional<cfg::section> section = document.find(section_keys[s]);
+			if (!section)
+				continue;
+			for (uint32_t v = 0; v < variable_count; ++v) {
+				switch (v % 5) {
+				case 0: sum += section->get<int32_t>(variable_keys[v], 0); break;
+				case 1: sum += section->get<double>(variable_keys[v], 0); break;
+				case 2: sum += section->get<std::string_view>(variable_keys[v], "").size(); break;
+				case 3: sum += section->get<bool>(variable_keys[v], false); break;
+				default: {
+					std::optional<cfg::list> list = section->get<cfg::list>(variable_keys[v]);
+					sum += list ? list->size() : 0;
+					break;
+				}
+				}
+			}
+		}
+	}
+	report("cpp", lookups, now() - start, sum);
+
+	// Iterating everything, C loops against range-based for
+	uint64_t visits = (uint64_t)iterations * section_count * variable_count;
+	sum = 0;
+	start = now();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		for (uint32_t s = 0; s < data->count; ++s) {
+			for (uint32_t v = 0; v < data->sections[s].count; ++v)
+				sum += (int)data->sections[s].variables[v].value.type;
+		}
+	}
+	report("c_iterate", visits, now() - start, sum);
+
+	sum = 0;
+	start = now();
+	for (uint32_t i = 0; i < iterations; ++i) {
+		for (cfg::section section : document) {
+			for (cfg::variable variable : section)
+				sum += (int)variable.value().type();
+		}
+	}
+	report("cpp_iterate", visits, now() - start, sum);
+
+	return 0;
+}
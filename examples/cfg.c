@@ -0,0 +1,7 @@
+/*
+ The implementation of cfg.h for the C++ examples, cfg.hpp only wraps it.
+ */
+
+#include <stdio.h>
+#define CFG_IMPLEMENTATION
+#include "../cfg.h"
@@ -0,0 +1,40 @@
+/*
+ This is an example of layering configs: overlay.cfg includes example.cfg and overrides some of its variables.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#define CFG_IMPLEMENTATION
+#include "../cfg.h"
+
+void print_variable(cfg_overlay_t *overlay, char *section, char *name) {
+	cfg_variable_t *variable = cfg_overlay_get(overlay, section, name);
+	if (!variable)
+		printf("[%s] %s is not set\n", section, name);
+	else if (variable->value.type == CFG_STRING)
+		printf("[%s] %s = \"%s\"\n", section, name, variable->value.value_string);
+	else if (variable->value.type == CFG_INT)
+		printf("[%s] %s = %d\n", section, name, variable->value.value_int);
+}
+
+int main(int argc, char *argv[]) {
+	(void)argc;
+	(void)argv;
+
+	cfg_overlay_t overlay = { 0 };
+	if (!cfg_overlay_add_file(&overlay, "overlay.cfg"))
+		printf("Not every file could be read\n");
+
+	for (uint32_t i = 0; i < overlay.count; ++i)
+		printf("Layer %u: %s\n", i, overlay.layers[i].path);
+
+	// Lookups resolve through the layers, the last one wins
+	print_variable(&overlay, "Network Configuration", "host");
+	print_variable(&overlay, "Network Configuration", "port");
+	print_variable(&overlay, "Network Configuration", "retry_attempts");
+	print_variable(&overlay, "Staging", "banner");
+	print_variable(&overlay, "Staging", "missing");
+
+	cfg_overlay_free(&overlay);
+	return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ This is an example of a cfg config being used as a meta program, like structs.c, which also generates the
+ cfg_schema_t tables that cfg_bind needs to parse sections straight into the generated structs.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#define CFG_IMPLEMENTATION
+#include "../cfg.h"
+
+typedef struct c_type c_type_t;
+
+struct c_type {
+	char *name;
+	cfg_type_t type;
+};
+
+static c_type_t c_types[] = {
+	{ "int", CFG_INT },
+	{ "int32_t", CFG_INT },
+	{ "double", CFG_FLOAT },
+	{ "char *", CFG_STRING },
+	{ "uint8_t", CFG_BOOL },
+	{ "cfg_list_t *", CFG_LIST }
+};
+
+char *type_string(uint32_t type) {
+	switch (type) {
+	case CFG_INT:
+		return "CFG_INT";
+	case CFG_FLOAT:
+		return "CFG_FLOAT";
+	case CFG_STRING:
+		return "CFG_STRING";
+	case CFG_BOOL:
+		return "CFG_BOOL";
+	case CFG_LIST:
+	default:
+		return "CFG_LIST";
+	}
+}
+
+void print_default(cfg_value_t value) {
+	switch (value.type) {
+	case CFG_INT:
+		printf("{ CFG_INT, { .value_int = %d } }", value.value_int);
+		break;
+	case CFG_FLOAT:
+		printf("{ CFG_FLOAT, { .value_float = %.17g } }", value.value_float);
+		break;
+	case CFG_STRING:
+		printf("{ CFG_STRING, { .value_string = \"%s\" } }", value.value_string);
+		break;
+	case CFG_BOOL:
+		printf("{ CFG_BOOL, { .value_bool = %d } }", value.value_bool);
+		break;
+	default:
+		break;
+	}
+}
+
+int main(int argc, char *argv[]) {
+	const uint64_t struct_hash = cfg_hash("@struct");
+
+	cfg_data_t data = cfg_data_read_file(argc > 1 ? argv[1] : "schema.cfg");
+
+	// The tables need offsetof, and cfg.h for their types. Its implementation is left to the including program
+	printf("#include <stddef.h>\n#include <stdint.h>\n#include \"cfg.h\"\n\n");
+
+	for (uint32_t s = 0; s < data.count; ++s) {
+		cfg_section_t section = data.sections[s];
+		if (!section.tag_count || cfg_hash(section.tags[0]) != struct_hash)
+			continue;
+
+		// The field types, NULL where the C type has no cfg type
+		c_type_t **types = calloc(section.count, sizeof(c_type_t *));
+		cfg_value_t *defaults = calloc(section.count, sizeof(cfg_value_t));
+		uint8_t *has_default = calloc(section.count, sizeof(uint8_t));
+		uint32_t field_count = 0;
+
+		printf("typedef struct %s %s_t;\nstruct %s {\n", section.name, section.name, section.name);
+		for (uint32_t v = 0; v < section.count; ++v) {
+			cfg_variable_t variable = section.variables[v];
+			cfg_value_t value = variable.value;
+
+			// Either "type" or ("type" default)
+			if (value.type == CFG_LIST && value.value_list->count) {
+				if (value.value_list->count > 1) {
+					defaults[v] = value.value_list->values[1];
+					has_default[v] = 1;
+				}
+				value = value.value_list->values[0];
+			}
+			if (value.type != CFG_STRING)
+				continue;
+
+			uint64_t hash = cfg_hash(value.value_string);
+			for (uint32_t t = 0; t < sizeof(c_types) / sizeof(c_types[0]); ++t) {
+				if (cfg_hash(c_types[t].name) == hash) {
+					types[v] = &c_types[t];
+					++field_count;
+				}
+			}
+			if (!types[v])
+				fprintf(stderr, "%s.%s: %s cannot be bound\n", section.name, variable.name, value.value_string);
+			if (defaults[v].type == CFG_LIST) {
+				fprintf(stderr, "%s.%s: list defaults are not supported\n", section.name, variable.name);
+				has_default[v] = 0;
+			}
+			// cfg_bind widens ints into doubles, every other default must have the type of its field
+			if (types[v] && has_default[v] && defaults[v].type != types[v]->type &&
+			    !(defaults[v].type == CFG_INT && types[v]->type == CFG_FLOAT)) {
+				fprintf(stderr, "%s.%s: %s default does not fit %s\n", section.name, variable.name,
+				        type_string(defaults[v].type), value.value_string);
+				has_default[v] = 0;
+			}
+
+			printf("\t%s %s;\n", value.value_string, variable.name);
+		}
+		printf("};\n\n");
+
+		printf("cfg_field_t %s_fields[] = {\n", section.name);
+		for (uint32_t v = 0; v < section.count; ++v) {
+			if (!types[v])
+				continue;
+			printf("\t{ \"%s\", %s, offsetof(%s_t, %s), ", section.variables[v].name, type_string(types[v]->type),
+			                                             section.name, section.variables[v].name);
+			if (has_default[v])
+				print_default(defaults[v]);
+			else
+				printf("{ 0 }");
+			printf(" },\n");
+		}
+		printf("};\n\n");
+		printf("cfg_schema_t %s_schema = { sizeof(%s_t), %u, %s_fields };\n\n", section.name, section.name, field_count, section.name);
+
+		free(types);
+		free(defaults);
+		free(has_default);
+	}
+
+	cfg_data_free(&data);
+	return 0;
+}